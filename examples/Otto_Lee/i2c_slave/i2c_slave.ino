@@ -1,7 +1,7 @@
 /**
  * @file i2c_slave.ino
  * @author David LEVAL (dleval@dle-dev.com)
- * @brief Otto Calibration Tool
+ * @brief Otto Lee driven by an I2C master (see OttoI2C.h for the commands)
  * @version 1.0
  * @date 2021-01-26
  * 
@@ -22,6 +22,7 @@
 
 #include <Arduino.h>
 #include <OttoLee.h>
+#include <OttoI2C.h>
 #include <Wire.h>
 
 // Pinout configuration ------------------------------------------------
@@ -43,41 +44,21 @@
 // Otto driver object --------------------------------------------------
 OttoLee otto(PIN_LEG_L, PIN_LEG_R, PIN_FOOT_L, PIN_FOOT_R, PIN_ARM_L, PIN_ARM_R, PIN_HEAD, PIN_NoiseSensor, PIN_Buzzer, PIN_Trigger, PIN_Echo);
 
-// I2C Function prototypes ---------------------------------------------
-void i2cReceiveEvent(int numBytes);
-void i2cRequestEvent(void);
+// I2C peripheral: the received commands are executed by update() -----
+// Example frames sent by the master:
+//   walk 4 steps forward, T=1000: 0x20 GAIT_WALK 4 0xE8 0x03 0 1
+//   read the distance:            write 0x05, then read 2 bytes
+OttoI2C<OttoLee> i2c(otto);
 
 
 void setup() {
-  Serial.begin(115200);
-
-  Wire.begin(I2C_ADDRESS);
-  Wire.onReceive(i2cReceiveEvent);
-  Wire.onRequest(i2cRequestEvent);
-
   otto.init(true);
   otto.home();
 
+  i2c.begin(I2C_ADDRESS);
 }
 
 void loop() {
-  // put your main code here, to run repeatedly:
-
-}
-
-// I2C Function  -------------------------------------------------------
-
-void i2cReceiveEvent(int numBytes)
-{
-  while (1 < Wire.available()) { // loop through all but the last
-    char c = Wire.read(); // receive byte as a character
-    Serial.print(c);         // print the character
-  }
-  int x = Wire.read();    // receive byte as an integer
-  Serial.println(x);         // print the integer
-}
-
-void i2cRequestEvent(void)
-{
-  Wire.write("hello "); // respond with message of 6 bytes
+  otto.run();
+  i2c.update();
 }
@@ -0,0 +1,255 @@
+/**
+ * @file Arduino.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <Wire.h>
+#include "HostSim.h"
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+TwoWire Wire;
+
+/** Time **********************************************************************/
+
+unsigned long millis()
+{
+    return (unsigned long)(HostSim::tick() / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)HostSim::tick();
+}
+
+void delay(unsigned long ms)
+{
+    HostSim::advance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    HostSim::advance(us);
+}
+
+/** I/O ***********************************************************************/
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+    HostSim::writePin(pin, level);
+}
+
+int digitalRead(uint8_t pin)
+{
+    return HostSim::pinLevel(pin);
+}
+
+int analogRead(uint8_t pin)
+{
+    //-- 13 ADC clocks at 125kHz
+    HostSim::advance(104);
+    return HostSim::analogValue(pin);
+}
+
+/**
+ * @brief Pulse set with HostSim::setPulse(). The clock advances by the
+ * width of the pulse, or by the timeout if the pulse is too long.
+ */
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout)
+{
+    (void)state;
+    uint32_t width = HostSim::pulseValue(pin);
+
+    if ((width == 0) || (width > timeout)) {
+        HostSim::advance(timeout);
+        return 0;
+    }
+    HostSim::advance(width);
+    return width;
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration)
+{
+    (void)duration;
+    HostSim::writeTone(pin, frequency);
+}
+
+void noTone(uint8_t pin)
+{
+    HostSim::writeTone(pin, 0);
+}
+
+/** Interrupts ****************************************************************/
+
+void noInterrupts()
+{
+    HostSim::setInterrupts(false);
+}
+
+void interrupts()
+{
+    HostSim::setInterrupts(true);
+}
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode)
+{
+    HostSim::attachInterrupt(interrupt, handler, mode);
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+    HostSim::attachInterrupt(interrupt, NULL, 0);
+}
+
+/** Math **********************************************************************/
+
+long random(long howbig)
+{
+    if (howbig == 0) return 0;
+    return rand() % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+    if (seed != 0) srand(seed);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+/** Print / Serial ************************************************************/
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+}
+
+size_t Print::print(const char *s)
+{
+    return write((const uint8_t *)s, strlen(s));
+}
+
+size_t Print::print(long n, int base)
+{
+    char buffer[40];
+    if (base == HEX) snprintf(buffer, sizeof(buffer), "%lX", n);
+    else snprintf(buffer, sizeof(buffer), "%ld", n);
+    return print(buffer);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+    char buffer[40];
+    if (base == HEX) snprintf(buffer, sizeof(buffer), "%lX", n);
+    else snprintf(buffer, sizeof(buffer), "%lu", n);
+    return print(buffer);
+}
+
+size_t Print::print(double n, int digits)
+{
+    char buffer[40];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+    return print(buffer);
+}
+
+int HardwareSerial::available()
+{
+    return HostSim::serialAvailable();
+}
+
+int HardwareSerial::read()
+{
+    return HostSim::serialRead();
+}
+
+int HardwareSerial::peek()
+{
+    int c = HostSim::serialRead();
+    if (c >= 0) HostSim::serialUnread();
+    return c;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    fputc(c, stdout);
+    return 1;
+}
+
+/** Wire **********************************************************************/
+
+size_t TwoWire::write(uint8_t c)
+{
+    if (_txLength >= BUFFER_LENGTH) return 0;
+    _txBuffer[_txLength++] = c;
+    return 1;
+}
+
+/**
+ * @brief Master write transaction to the peripheral: the bytes are given to
+ * the onReceive handler, as one frame
+ *
+ * @param data      Bytes sent by the master
+ * @param length    Number of bytes (BUFFER_LENGTH at most)
+ * @return true     Acknowledged (the peripheral is started)
+ */
+bool TwoWire::masterWrite(const uint8_t *data, uint8_t length)
+{
+    if ((_address == 0) || (length > BUFFER_LENGTH)) return false;
+    memcpy(_rxBuffer, data, length);
+    _rxLength = length;
+    _rxPos = 0;
+    if (_onReceive != NULL) _onReceive(length);
+    return true;
+}
+
+/**
+ * @brief Master read transaction: the onRequest handler fills the answer,
+ * the bytes it did not write are read as 0xFF
+ *
+ * @param data      Bytes received by the master
+ * @param length    Number of bytes to read
+ * @return uint8_t  Number of bytes written by the peripheral
+ */
+uint8_t TwoWire::masterRead(uint8_t *data, uint8_t length)
+{
+    if (_address == 0) return 0;
+    _txLength = 0;
+    if (_onRequest != NULL) _onRequest();
+    for (uint8_t i = 0; i < length; i++) data[i] = (i < _txLength) ? _txBuffer[i] : 0xFF;
+    return _txLength;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file Arduino.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host (Linux) stand-in for the Arduino core, backed by HostSim
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ARDUINO_h
+#define HOST_ARDUINO_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifdef __cplusplus
+  //-- Before the min / max macros
+  #include <algorithm>
+  #include <vector>
+#endif
+
+#ifndef ARDUINO
+  #define ARDUINO     10819
+#endif
+#ifndef F_CPU
+  #define F_CPU       16000000UL
+#endif
+
+//-- Program memory is plain memory on the host
+#define PROGMEM
+#define PSTR(s)                 (s)
+#define F(s)                    (s)
+#define memcpy_P                memcpy
+#define strlen_P                strlen
+#define pgm_read_byte(a)        (*(const uint8_t *)(a))
+#define pgm_read_word(a)        (*(const uint16_t *)(a))
+#define pgm_read_dword(a)       (*(const uint32_t *)(a))
+#define pgm_read_float(a)       (*(const float *)(a))
+#define pgm_read_ptr(a)         (*(void * const *)(a))
+
+#define HIGH                    1
+#define LOW                     0
+#define INPUT                   0
+#define OUTPUT                  1
+#define INPUT_PULLUP            2
+#define CHANGE                  1
+#define FALLING                 2
+#define RISING                  3
+#define DEC                     10
+#define HEX                     16
+#define NOT_AN_INTERRUPT        -1
+
+//-- Arduino Nano / UNO analog pins
+#define A0                      14
+#define A1                      15
+#define A2                      16
+#define A3                      17
+#define A4                      18
+#define A5                      19
+#define A6                      20
+#define A7                      21
+
+#define min(a,b)                ((a)<(b)?(a):(b))
+#define max(a,b)                ((a)>(b)?(a):(b))
+#define constrain(x,lo,hi)      ((x)<(lo)?(lo):((x)>(hi)?(hi):(x)))
+#define sq(x)                   ((x)*(x))
+#define digitalPinToInterrupt(p) (p)
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+//-- Time
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+//-- I/O
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout = 1000000L);
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+//-- Interrupts
+void noInterrupts();
+void interrupts();
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+
+//-- Math
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+/**
+ * @brief Minimal Arduino Print / Stream classes
+ */
+class Print
+{
+public:
+    virtual ~Print() {};
+    virtual size_t write(uint8_t c) = 0;
+    size_t write(const uint8_t *buffer, size_t size);
+    size_t print(const char *s);
+    size_t print(char c) {return write((uint8_t)c);};
+    size_t print(long n, int base = DEC);
+    size_t print(int n, int base = DEC) {return print((long)n, base);};
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(unsigned int n, int base = DEC) {return print((unsigned long)n, base);};
+    size_t print(double n, int digits = 2);
+    size_t println() {return print("\r\n");};
+    template <typename T> size_t println(T value) {size_t n = print(value); return n + println();};
+    template <typename T> size_t println(T value, int format) {size_t n = print(value, format); return n + println();};
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+/**
+ * @brief Serial port: the output goes to stdout, the input is given with
+ * HostSim::serialInput()
+ */
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long baud) {(void)baud;};
+    void end() {};
+    int available();
+    int read();
+    int peek();
+    void flush() {};
+    size_t write(uint8_t c);
+    using Print::write;
+    operator bool() {return true;};
+};
+
+extern HardwareSerial Serial;
+
+#endif //HOST_ARDUINO_h
@@ -0,0 +1,49 @@
+/**
+ * @file EEPROM.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host (Linux) stand-in for the Arduino EEPROM library
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_EEPROM_h
+#define HOST_EEPROM_h
+
+#include <stdint.h>
+#include <string.h>
+
+#define HOST_EEPROM_SIZE    1024    //-- ATmega328P
+
+/**
+ * @brief EEPROM in RAM, erased (0xFF) at start
+ */
+class EEPROMClass
+{
+public:
+    EEPROMClass() {memset(_data, 0xFF, sizeof(_data));};
+    uint8_t read(int address) {return _data[address % HOST_EEPROM_SIZE];};
+    void write(int address, uint8_t value) {_data[address % HOST_EEPROM_SIZE] = value;};
+    void update(int address, uint8_t value) {write(address, value);};
+    uint16_t length() {return HOST_EEPROM_SIZE;};
+
+private:
+    uint8_t _data[HOST_EEPROM_SIZE];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif //HOST_EEPROM_h
@@ -0,0 +1,38 @@
+/**
+ * @file HostPins.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Pins of the robot in the host programs, as in the examples
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOSTPINS_h
+#define HOSTPINS_h
+
+#define PIN_LEG_L         2   // Left leg servo
+#define PIN_LEG_R         3   // Right leg servo
+#define PIN_FOOT_L        4   // Left foot servo
+#define PIN_FOOT_R        5   // Right foot servo
+#define PIN_ARM_L         6   // Left arm servo (Otto Lee)
+#define PIN_ARM_R         7   // Right arm servo (Otto Lee)
+#define PIN_HEAD          10  // Head servo (Otto Lee)
+#define PIN_Trigger       8   // Ultrasound distance sensor (Trigger)
+#define PIN_Echo          9   // Ultrasound distance sensor (Echo)
+#define PIN_NoiseSensor   A6
+#define PIN_Buzzer        13  // Buzzer
+
+#endif //HOSTPINS_h
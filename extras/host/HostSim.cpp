@@ -0,0 +1,346 @@
+/**
+ * @file HostSim.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include "HostSim.h"
+
+uint64_t HostSim::_now = 0;
+uint16_t HostSim::_autoAdvance = HOST_AUTO_ADVANCE;
+bool HostSim::_interrupts = true;
+uint8_t HostSim::_recordMask = HOST_EVENT_ALL;
+uint8_t HostSim::_level[HOST_PINS];
+uint16_t HostSim::_analog[HOST_PINS];
+uint32_t HostSim::_pulse[HOST_PINS];
+int16_t HostSim::_servo[HOST_PINS];
+void (*HostSim::_handler[HOST_PINS])(void);
+int HostSim::_handlerMode[HOST_PINS];
+bool HostSim::_pending[HOST_PINS];
+HostAnalogSource HostSim::_analogSource = NULL;
+std::vector<HostEvent> HostSim::_events;
+std::vector<uint8_t> HostSim::_serialIn;
+size_t HostSim::_serialPos = 0;
+std::vector<HostEvent> HostSim::_scheduled;
+uint8_t HostSim::_echoTrigger = HOST_PINS;
+uint8_t HostSim::_echoPin = HOST_PINS;
+uint8_t HostSim::_failed = 0;
+
+/** Virtual clock *************************************************************/
+
+/**
+ * @brief Restart the board: clock at 0, pins low, no recorded events.
+ * The interrupt handlers are kept: they are usually attached by global
+ * objects, before main() can call reset().
+ *
+ */
+void HostSim::reset()
+{
+    _now = 0;
+    _autoAdvance = HOST_AUTO_ADVANCE;
+    _interrupts = true;
+    _recordMask = HOST_EVENT_ALL;
+    for (uint8_t pin = 0; pin < HOST_PINS; pin++) {
+        _level[pin] = LOW;
+        _analog[pin] = 0;
+        _pulse[pin] = 0;
+        _servo[pin] = -1;
+        _pending[pin] = false;
+    }
+    _analogSource = NULL;
+    _events.clear();
+    _serialIn.clear();
+    _serialPos = 0;
+    _scheduled.clear();
+    _echoTrigger = HOST_PINS;
+    _echoPin = HOST_PINS;
+}
+
+/**
+ * @brief Fast-forward the clock
+ *
+ * @param us Time to skip (us)
+ */
+void HostSim::advance(uint64_t us)
+{
+    _now += us;
+    _runScheduled();
+}
+
+/**
+ * @brief Clock read by millis() / micros(): advances by the auto step
+ *
+ * @return uint64_t Time (us)
+ */
+uint64_t HostSim::tick()
+{
+    _now += _autoAdvance;
+    _runScheduled();
+    return _now;
+}
+
+/** Inputs ********************************************************************/
+
+/**
+ * @brief Drive an input pin. The attached interrupt handler is called on
+ * the matching edge.
+ *
+ * @param pin
+ * @param level HIGH / LOW
+ */
+void HostSim::setPin(uint8_t pin, uint8_t level)
+{
+    if (pin >= HOST_PINS) return;
+    uint8_t previous = _level[pin];
+    _level[pin] = level ? HIGH : LOW;
+    if ((_handler[pin] == NULL) || (previous == _level[pin])) return;
+
+    int mode = _handlerMode[pin];
+    if ((mode == CHANGE) || ((mode == RISING) && _level[pin]) || ((mode == FALLING) && !_level[pin])) {
+        //-- Like the hardware, an interrupt raised while disabled runs once enabled
+        if (_interrupts) _handler[pin]();
+        else _pending[pin] = true;
+    }
+}
+
+/**
+ * @brief noInterrupts() / interrupts(): the pending handlers run when the
+ * interrupts are enabled again
+ *
+ * @param enabled
+ */
+void HostSim::setInterrupts(bool enabled)
+{
+    _interrupts = enabled;
+    if (!enabled) return;
+    for (uint8_t pin = 0; pin < HOST_PINS; pin++) {
+        if (_pending[pin] && (_handler[pin] != NULL)) {
+            _pending[pin] = false;
+            _handler[pin]();
+        }
+    }
+}
+
+/**
+ * @brief Value returned by analogRead()
+ *
+ * @param pin
+ * @param value 0 to 1023
+ */
+void HostSim::setAnalog(uint8_t pin, uint16_t value)
+{
+    if (pin < HOST_PINS) _analog[pin] = value;
+}
+
+/**
+ * @brief Width of the pulse measured by pulseIn() (e.g. ultrasonic echo)
+ *
+ * @param pin
+ * @param us Pulse width (us), 0 = no pulse
+ */
+void HostSim::setPulse(uint8_t pin, uint32_t us)
+{
+    if (pin < HOST_PINS) _pulse[pin] = us;
+}
+
+/**
+ * @brief Ultrasonic sensor: each ping on the trigger pin (falling edge)
+ * is answered by an echo pulse on the echo pin. pulseIn() on the echo pin
+ * returns the same width.
+ *
+ * @param trigger   Trigger pin
+ * @param echo      Echo pin
+ * @param us        Echo width (us), 0 = no echo
+ */
+void HostSim::setEcho(uint8_t trigger, uint8_t echo, uint32_t us)
+{
+    _echoTrigger = trigger;
+    _echoPin = echo;
+    setPulse(echo, us);
+}
+
+/**
+ * @brief Change an input pin at a given time (interrupts included)
+ *
+ * @param time  Virtual time (us)
+ * @param pin
+ * @param level HIGH / LOW
+ */
+void HostSim::schedulePin(uint64_t time, uint8_t pin, uint8_t level)
+{
+    HostEvent e = {time, HOST_EVENT_PIN, pin, level};
+    std::vector<HostEvent>::iterator it = _scheduled.begin();
+    while ((it != _scheduled.end()) && (it->time <= time)) it++;
+    _scheduled.insert(it, e);
+}
+
+void HostSim::_runScheduled()
+{
+    while (!_scheduled.empty() && (_scheduled.front().time <= _now)) {
+        HostEvent e = _scheduled.front();
+        _scheduled.erase(_scheduled.begin());
+        setPin(e.pin, e.value);
+    }
+}
+
+/**
+ * @brief Bytes received by the Serial port
+ *
+ * @param data
+ * @param length
+ */
+void HostSim::serialInput(const uint8_t *data, uint16_t length)
+{
+    _serialIn.insert(_serialIn.end(), data, data + length);
+}
+
+/** Board state ***************************************************************/
+
+uint8_t HostSim::pinLevel(uint8_t pin)
+{
+    return (pin < HOST_PINS) ? _level[pin] : LOW;
+}
+
+uint16_t HostSim::analogValue(uint8_t pin)
+{
+    if (_analogSource != NULL) return _analogSource(pin, _now);
+    return (pin < HOST_PINS) ? _analog[pin] : 0;
+}
+
+uint32_t HostSim::pulseValue(uint8_t pin)
+{
+    return (pin < HOST_PINS) ? _pulse[pin] : 0;
+}
+
+/**
+ * @brief Last value written to a servo
+ *
+ * @param pin
+ * @return int16_t Position (degrees) or pulse (us), -1 if never written
+ */
+int16_t HostSim::servoValue(uint8_t pin)
+{
+    return (pin < HOST_PINS) ? _servo[pin] : -1;
+}
+
+/**
+ * @brief Output pin write, the edges are recorded
+ *
+ * @param pin
+ * @param level
+ */
+void HostSim::writePin(uint8_t pin, uint8_t level)
+{
+    if (pin >= HOST_PINS) return;
+    level = level ? HIGH : LOW;
+    if (level != _level[pin]) _record(HOST_EVENT_PIN, pin, level);
+    //-- End of an ultrasonic ping: schedule the echo
+    if ((pin == _echoTrigger) && !level && _level[pin] && (_pulse[_echoPin] > 0)) {
+        schedulePin(_now + HOST_ECHO_DELAY, _echoPin, HIGH);
+        schedulePin(_now + HOST_ECHO_DELAY + _pulse[_echoPin], _echoPin, LOW);
+    }
+    _level[pin] = level;
+}
+
+void HostSim::writeServo(uint8_t pin, int16_t value, uint8_t type)
+{
+    if (pin >= HOST_PINS) return;
+    _servo[pin] = value;
+    _record(type, pin, value);
+}
+
+void HostSim::writeTone(uint8_t pin, uint32_t frequency)
+{
+    _record(HOST_EVENT_TONE, pin, frequency);
+}
+
+void HostSim::attachInterrupt(uint8_t pin, void (*handler)(void), int mode)
+{
+    if (pin >= HOST_PINS) return;
+    _handler[pin] = handler;
+    _handlerMode[pin] = mode;
+}
+
+int HostSim::serialAvailable()
+{
+    return _serialIn.size() - _serialPos;
+}
+
+int HostSim::serialRead()
+{
+    if (_serialPos >= _serialIn.size()) return -1;
+    return _serialIn[_serialPos++];
+}
+
+/** Recorder ******************************************************************/
+
+/**
+ * @brief Number of recorded events of a type
+ *
+ * @param type  HOST_EVENT_xxx
+ * @param pin   Pin, -1 for all the pins
+ * @return uint32_t
+ */
+uint32_t HostSim::count(uint8_t type, int16_t pin)
+{
+    uint32_t n = 0;
+
+    for (size_t i = 0; i < _events.size(); i++) {
+        if ((_events[i].type == type) && ((pin < 0) || (_events[i].pin == pin))) n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Write the recorded events as CSV: time (us), type, pin, value
+ *
+ * @param file
+ */
+void HostSim::dump(FILE *file)
+{
+    for (size_t i = 0; i < _events.size(); i++) {
+        const HostEvent &e = _events[i];
+        fprintf(file, "%llu,%u,%u,%ld\n", (unsigned long long)e.time, e.type, e.pin, (long)e.value);
+    }
+}
+
+/** Checks ********************************************************************/
+
+/**
+ * @brief Print the result of a check, count it when failed (see failed(),
+ * the exit code of the host checks)
+ *
+ * @param name      What is checked
+ * @param ok        Result
+ * @param value     Measured value, printed after the name
+ * @return true     ok
+ */
+bool HostSim::check(const char *name, bool ok, long value)
+{
+    printf("%-4s %s (%ld)\n", ok ? "ok" : "FAIL", name, value);
+    if (!ok) _failed++;
+    return ok;
+}
+
+void HostSim::_record(uint8_t type, uint8_t pin, int32_t value)
+{
+    if (!(_recordMask & type)) return;
+    HostEvent e = {_now, type, pin, value};
+    _events.push_back(e);
+}
@@ -0,0 +1,132 @@
+/**
+ * @file HostSim.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host (Linux) simulation of the Arduino board: virtual clock and I/O recorder
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOSTSIM_h
+#define HOSTSIM_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/** Configuration *************************************************************/
+#define HOST_PINS               32
+#define HOST_AUTO_ADVANCE       10      //-- Default clock advance per millis() / micros() call (us)
+#define HOST_ECHO_DELAY         450     //-- Ultrasonic sensor: trigger to echo start (us)
+
+//-- Recorded events
+#define HOST_EVENT_SERVO        0x01    //-- Servo write (value: degrees)
+#define HOST_EVENT_SERVO_US     0x02    //-- Servo write (value: microseconds)
+#define HOST_EVENT_PIN          0x04    //-- Output pin edge (value: level)
+#define HOST_EVENT_TONE         0x08    //-- tone() / noTone() (value: frequency, 0 = off)
+#define HOST_EVENT_ALL          0xFF
+
+/******************************************************************************/
+
+/**
+ * @brief Recorded I/O event
+ */
+typedef struct {
+    uint64_t time;      //-- Virtual time (us)
+    uint8_t type;       //-- HOST_EVENT_xxx
+    uint8_t pin;
+    int32_t value;
+} HostEvent;
+
+typedef uint16_t (*HostAnalogSource)(uint8_t pin, uint64_t time);
+
+/**
+ * @brief Simulated board used by the host build of the library
+ *
+ * The clock only moves when the code waits (delay, delayMicroseconds,
+ * pulseIn), when it is advanced explicitly, and by a small step on each
+ * millis() / micros() call so that polling loops make progress.
+ * A motion of several seconds therefore runs in a few milliseconds.
+ */
+class HostSim
+{
+public:
+    //-- Virtual clock
+    static void reset();
+    static uint64_t now() {return _now;};
+    static void advance(uint64_t us);
+    static void setAutoAdvance(uint16_t us) {_autoAdvance = us;};
+    static uint64_t tick();
+
+    //-- Inputs
+    static void setPin(uint8_t pin, uint8_t level);
+    static void setAnalog(uint8_t pin, uint16_t value);
+    static void setAnalogSource(HostAnalogSource source) {_analogSource = source;};
+    static void setPulse(uint8_t pin, uint32_t us);
+    static void setEcho(uint8_t trigger, uint8_t echo, uint32_t us);
+    static void schedulePin(uint64_t time, uint8_t pin, uint8_t level);
+    static void serialInput(const uint8_t *data, uint16_t length);
+
+    //-- Board state
+    static uint8_t pinLevel(uint8_t pin);
+    static uint16_t analogValue(uint8_t pin);
+    static uint32_t pulseValue(uint8_t pin);
+    static int16_t servoValue(uint8_t pin);
+    static void writePin(uint8_t pin, uint8_t level);
+    static void writeServo(uint8_t pin, int16_t value, uint8_t type);
+    static void writeTone(uint8_t pin, uint32_t frequency);
+    static void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+    static void setInterrupts(bool enabled);
+    static int serialRead();
+    static void serialUnread() {if (_serialPos > 0) _serialPos--;};
+    static int serialAvailable();
+
+    //-- Recorder
+    static void record(uint8_t mask) {_recordMask = mask;};
+    static const std::vector<HostEvent> &events() {return _events;};
+    static uint32_t count(uint8_t type, int16_t pin = -1);
+    static void clearEvents() {_events.clear();};
+    static void dump(FILE *file);
+
+    //-- Checks of the host programs: one line each, "ok" or "FAIL"
+    static bool check(const char *name, bool ok, long value);
+    static uint8_t failed() {return _failed;};
+
+private:
+    static uint64_t _now;
+    static uint16_t _autoAdvance;
+    static bool _interrupts;
+    static uint8_t _recordMask;
+    static uint8_t _level[HOST_PINS];
+    static uint16_t _analog[HOST_PINS];
+    static uint32_t _pulse[HOST_PINS];
+    static int16_t _servo[HOST_PINS];
+    static void (*_handler[HOST_PINS])(void);
+    static int _handlerMode[HOST_PINS];
+    static bool _pending[HOST_PINS];         //-- Interrupt raised while disabled
+    static HostAnalogSource _analogSource;
+    static std::vector<HostEvent> _events;
+    static std::vector<uint8_t> _serialIn;
+    static size_t _serialPos;
+    static std::vector<HostEvent> _scheduled;  //-- Input changes to come, by time
+    static uint8_t _echoTrigger;
+    static uint8_t _echoPin;
+    static uint8_t _failed;
+    static void _runScheduled();
+    static void _record(uint8_t type, uint8_t pin, int32_t value);
+};
+
+#endif //HOSTSIM_h
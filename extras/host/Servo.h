@@ -0,0 +1,67 @@
+/**
+ * @file Servo.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host (Linux) stand-in for the Arduino Servo library, backed by HostSim
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_SERVO_h
+#define HOST_SERVO_h
+
+#include <Arduino.h>
+#include "HostSim.h"
+
+#define MIN_PULSE_WIDTH     544
+#define MAX_PULSE_WIDTH     2400
+#define INVALID_SERVO       255
+
+/**
+ * @brief Servo: every write is recorded by HostSim (HOST_EVENT_SERVO)
+ */
+class Servo
+{
+public:
+    Servo() {_pin = INVALID_SERVO; _value = 90;};
+    uint8_t attach(int pin) {_pin = pin; return 0;};
+    uint8_t attach(int pin, int min, int max) {(void)min; (void)max; return attach(pin);};
+    void detach() {_pin = INVALID_SERVO;};
+    bool attached() {return _pin != INVALID_SERVO;};
+    void write(int value);
+    void writeMicroseconds(int value);
+    int read() {return _value;};
+
+private:
+    uint8_t _pin;
+    int _value;
+};
+
+inline void Servo::write(int value)
+{
+    if (value < 0) value = 0;
+    if (value > 180) value = 180;
+    _value = value;
+    if (attached()) HostSim::writeServo(_pin, value, HOST_EVENT_SERVO);
+}
+
+inline void Servo::writeMicroseconds(int value)
+{
+    _value = map(value, MIN_PULSE_WIDTH, MAX_PULSE_WIDTH, 0, 180);
+    if (attached()) HostSim::writeServo(_pin, value, HOST_EVENT_SERVO_US);
+}
+
+#endif //HOST_SERVO_h
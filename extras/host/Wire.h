@@ -0,0 +1,70 @@
+/**
+ * @file Wire.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host (Linux) stand-in for the Arduino Wire library (I2C peripheral side)
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_WIRE_h
+#define HOST_WIRE_h
+
+#include <stdint.h>
+#include <Arduino.h>
+
+#define BUFFER_LENGTH   32      //-- Same buffers as the AVR Wire library
+
+/**
+ * @brief I2C bus seen from the peripheral. The test plays the master with
+ * masterWrite() and masterRead(), which call the onReceive / onRequest
+ * handlers like the TWI interrupt does.
+ */
+class TwoWire : public Stream
+{
+public:
+    TwoWire() : _address(0), _rxLength(0), _rxPos(0), _txLength(0), _onReceive(NULL), _onRequest(NULL) {};
+    void begin() {_address = 0;};
+    void begin(uint8_t address) {_address = address;};
+    void end() {};
+    void onReceive(void (*handler)(int)) {_onReceive = handler;};
+    void onRequest(void (*handler)(void)) {_onRequest = handler;};
+    int available() {return _rxLength - _rxPos;};
+    int read() {return (_rxPos < _rxLength) ? _rxBuffer[_rxPos++] : -1;};
+    int peek() {return (_rxPos < _rxLength) ? _rxBuffer[_rxPos] : -1;};
+    size_t write(uint8_t c);
+    using Print::write;
+    size_t write(const char *s) {return Print::write((const uint8_t *)s, strlen(s));};
+
+    //-- Host side: bus master
+    uint8_t getAddress() {return _address;};
+    bool masterWrite(const uint8_t *data, uint8_t length);
+    uint8_t masterRead(uint8_t *data, uint8_t length);
+
+private:
+    uint8_t _address;
+    uint8_t _rxBuffer[BUFFER_LENGTH];
+    uint8_t _rxLength;
+    uint8_t _rxPos;
+    uint8_t _txBuffer[BUFFER_LENGTH];
+    uint8_t _txLength;
+    void (*_onReceive)(int);
+    void (*_onRequest)(void);
+};
+
+extern TwoWire Wire;
+
+#endif //HOST_WIRE_h
@@ -0,0 +1,246 @@
+/**
+ * @file bench.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host micro-benchmarks of the library hot paths
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//-- One JSON object per line on stdout:
+//--   {"bench":"<name>","math":"fixed|float","calls":n,"ns_per_call":x,...}
+//-- "math" is the oscillator math selected at build time (__USE_OSC_FLOAT_MATH).
+//-- The times are host times: compare them between builds and releases,
+//-- not with the board. The simulated fields (sim_ms, blocked_us, writes,
+//-- edges) come from the virtual clock and do not depend on the host.
+
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+#include <OttoLee.h>
+#include "HostSim.h"
+#include "HostPins.h"
+
+#ifdef __USE_OSC_FLOAT_MATH
+  #define BENCH_MATH    "float"
+#else
+  #define BENCH_MATH    "fixed"
+#endif
+
+#define BENCH_RUNS        5     //-- The micro loops keep their best run
+
+OttoLee otto(PIN_LEG_L, PIN_LEG_R, PIN_FOOT_L, PIN_FOOT_R, PIN_ARM_L, PIN_ARM_R, PIN_HEAD, PIN_NoiseSensor, PIN_Buzzer, PIN_Trigger, PIN_Echo);
+
+static volatile int32_t _sink;
+
+/**
+ * @brief Host monotonic time
+ *
+ * @return uint64_t Time (ns)
+ */
+static uint64_t _ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void _report(const char *bench, uint32_t calls, uint64_t ns, const char *extra = "")
+{
+    printf("{\"bench\":\"%s\",\"math\":\"%s\",\"calls\":%lu,\"ns_per_call\":%.1f%s}\n",
+        bench, BENCH_MATH, (unsigned long)calls, calls ? (double)ns / calls : 0.0, extra);
+}
+
+/** Oscillator ****************************************************************/
+
+//-- Sine evaluation: float sin() against Oscillator::sinQ15 (the Q15 table,
+//-- or sin() itself in the float math build)
+static void _benchSine()
+{
+    const uint32_t calls = 1000000;
+    uint64_t best[2] = {UINT64_MAX, UINT64_MAX};
+
+    for (uint8_t run = 0; run < BENCH_RUNS; run++) {
+        uint64_t t0 = _ns();
+        for (uint32_t i = 0; i < calls; i++) _sink = (int32_t)(sin(i * (2 * M_PI / 65536)) * 32767);
+        best[0] = min(best[0], _ns() - t0);
+
+        t0 = _ns();
+        for (uint32_t i = 0; i < calls; i++) _sink = Oscillator::sinQ15((uint16_t)i);
+        best[1] = min(best[1], _ns() - t0);
+    }
+    _report("sin_float", calls, best[0]);
+    _report("sin_q15", calls, best[1]);
+}
+
+//-- Oscillator::refresh, with a new sample on every call and with none
+static void _benchRefresh()
+{
+    const uint32_t calls = 200000;
+    Oscillator osc;
+    uint64_t best[2] = {UINT64_MAX, UINT64_MAX};
+
+    HostSim::record(0);
+    osc.attach(2);
+    osc.SetA(30);
+    osc.SetO(10);
+    osc.SetT(1000);
+    osc.Reset(millis());
+
+    for (uint8_t run = 0; run < BENCH_RUNS; run++) {
+        uint64_t t0 = _ns();
+        for (uint32_t i = 0; i < calls; i++) {
+            HostSim::advance(30000);
+            osc.refresh();
+        }
+        best[0] = min(best[0], _ns() - t0);
+
+        t0 = _ns();
+        for (uint32_t i = 0; i < calls; i++) {
+            HostSim::advance(1);
+            osc.refresh();
+        }
+        best[1] = min(best[1], _ns() - t0);
+    }
+    _report("osc_refresh_sample", calls, best[0]);
+    _report("osc_refresh_idle", calls, best[1]);
+
+    osc.detach();
+}
+
+/** OttoServo *****************************************************************/
+
+typedef void (*GaitFunction)(void);
+
+static void _walk() {otto.walk(4, 1000, FORWARD);}
+static void _turn() {otto.turn(4, 1000, LEFT);}
+static void _updown() {otto.updown(4, 1000, 20);}
+static void _swing() {otto.swing(4, 1000, 20);}
+static void _tiptoeSwing() {otto.tiptoeSwing(4, 1000, 20);}
+static void _jitter() {otto.jitter(4, 1000, 20);}
+static void _ascendingTurn() {otto.ascendingTurn(4, 1000, 20);}
+static void _moonwalker() {otto.moonwalker(4, 1000, 20, LEFT);}
+static void _crusaito() {otto.crusaito(4, 1000, 20, FORWARD);}
+static void _flapping() {otto.flapping(4, 1000, 20, FORWARD);}
+static void _bend() {otto.bend(2, 1000, LEFT);}
+static void _jump() {otto.jump(2, 1000);}
+
+static const struct {
+    const char *name;
+    GaitFunction run;
+} _gaits[] = {
+    {"walk", _walk}, {"turn", _turn}, {"updown", _updown}, {"swing", _swing},
+    {"tiptoe_swing", _tiptoeSwing}, {"jitter", _jitter}, {"ascending_turn", _ascendingTurn},
+    {"moonwalker", _moonwalker}, {"crusaito", _crusaito}, {"flapping", _flapping},
+    {"bend", _bend}, {"jump", _jump}
+};
+
+//-- Motion engine: cost of update() while a gait is played
+static void _benchGaits()
+{
+    char extra[96];
+
+    otto.setBlocking(false);
+    for (uint8_t g = 0; g < sizeof(_gaits) / sizeof(_gaits[0]); g++) {
+        HostSim::record(HOST_EVENT_SERVO);
+        HostSim::clearEvents();
+        uint64_t sim0 = HostSim::now();
+        uint32_t calls = 0;
+
+        uint64_t t0 = _ns();
+        _gaits[g].run();
+        while (otto.update()) calls++;
+        uint64_t ns = _ns() - t0;
+
+        snprintf(extra, sizeof(extra), ",\"sim_ms\":%llu,\"writes\":%lu",
+            (unsigned long long)((HostSim::now() - sim0) / 1000), (unsigned long)HostSim::count(HOST_EVENT_SERVO));
+        char name[32];
+        snprintf(name, sizeof(name), "gait_%s", _gaits[g].name);
+        _report(name, calls, ns, extra);
+    }
+    otto.setBlocking(true);
+}
+
+/** OttoSound *****************************************************************/
+
+//-- Bit-banged tones: one call per song, cost per buzzer edge
+static void _benchSound()
+{
+    char extra[96];
+    static const struct {
+        const char *name;
+        uint8_t song;
+    } songs[] = {{"sing_happy", S_happy}, {"sing_surprise", S_surprise}, {"sing_fart3", S_fart3}};
+
+    HostSim::record(HOST_EVENT_PIN);
+    for (uint8_t s = 0; s < sizeof(songs) / sizeof(songs[0]); s++) {
+        HostSim::clearEvents();
+        uint64_t sim0 = HostSim::now();
+        uint64_t t0 = _ns();
+        otto.sing(songs[s].song);
+        uint64_t ns = _ns() - t0;
+        uint32_t edges = HostSim::count(HOST_EVENT_PIN, PIN_Buzzer);
+        snprintf(extra, sizeof(extra), ",\"sim_ms\":%llu,\"edges\":%lu,\"ns_per_edge\":%.1f",
+            (unsigned long long)((HostSim::now() - sim0) / 1000), (unsigned long)edges, edges ? (double)ns / edges : 0.0);
+        _report(songs[s].name, 1, ns, extra);
+    }
+
+    HostSim::clearEvents();
+    uint64_t sim0 = HostSim::now();
+    uint64_t t0 = _ns();
+    otto.bendTones(880, 2093, 1.02, 18, 1);
+    uint64_t ns = _ns() - t0;
+    snprintf(extra, sizeof(extra), ",\"sim_ms\":%llu,\"edges\":%lu",
+        (unsigned long long)((HostSim::now() - sim0) / 1000), (unsigned long)HostSim::count(HOST_EVENT_PIN, PIN_Buzzer));
+    _report("bend_tones", 1, ns, extra);
+}
+
+/** US ************************************************************************/
+
+//-- Ultrasonic read: host cost and time the caller is blocked
+static void _benchDistance()
+{
+    const uint32_t calls = 10000;
+    const uint32_t echo[] = {1160, 0};     //-- 20cm, no echo (timeout)
+    const char *names[] = {"us_read_20cm", "us_read_timeout"};
+    char extra[64];
+
+    HostSim::record(0);
+    for (uint8_t e = 0; e < 2; e++) {
+        HostSim::setPulse(PIN_Echo, echo[e]);
+        uint64_t sim0 = HostSim::now();
+        uint64_t t0 = _ns();
+        for (uint32_t i = 0; i < calls; i++) _sink = (int32_t)otto.getDistance();
+        uint64_t ns = _ns() - t0;
+        snprintf(extra, sizeof(extra), ",\"blocked_us\":%llu", (unsigned long long)((HostSim::now() - sim0) / calls));
+        _report(names[e], calls, ns, extra);
+    }
+}
+
+int main()
+{
+    HostSim::reset();
+    HostSim::record(0);
+    otto.init(false);
+
+    _benchSine();
+    _benchRefresh();
+    _benchGaits();
+    _benchSound();
+    _benchDistance();
+
+    return 0;
+}
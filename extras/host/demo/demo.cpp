@@ -0,0 +1,54 @@
+/**
+ * @file demo.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host simulation of Otto: walk and play Tetris, then print what was
+ * sent to the servos and the buzzer
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <Otto.h>
+#include "HostSim.h"
+#include "HostPins.h"
+
+Otto otto(PIN_LEG_L, PIN_LEG_R, PIN_FOOT_L, PIN_FOOT_R, PIN_NoiseSensor, PIN_Buzzer, PIN_Trigger, PIN_Echo);
+
+int main(int argc, char *argv[])
+{
+    HostSim::reset();
+    HostSim::setPulse(PIN_Echo, 1160);  //-- Obstacle at 20cm
+
+    otto.init(false);
+
+    uint64_t start = HostSim::now();
+    otto.walk(4, 1000, FORWARD);
+    printf("walk: %llu ms, %u servo writes\n", (unsigned long long)((HostSim::now() - start) / 1000), HostSim::count(HOST_EVENT_SERVO));
+
+    HostSim::clearEvents();
+    start = HostSim::now();
+    otto.songTetris();
+    printf("tetris: %llu ms, %u buzzer edges\n", (unsigned long long)((HostSim::now() - start) / 1000), HostSim::count(HOST_EVENT_PIN, PIN_Buzzer));
+
+    printf("distance: %d cm\n", (int)otto.getDistance());
+
+    //-- "demo --dump": recorded events as CSV
+    if ((argc > 1) && (strcmp(argv[1], "--dump") == 0)) HostSim::dump(stdout);
+
+    return 0;
+}
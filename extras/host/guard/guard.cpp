@@ -0,0 +1,134 @@
+/**
+ * @file guard.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host check of the guarded walk: reaction time to an obstacle
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//-- An obstacle appears in the middle of a step; the reaction is the time
+//-- until the walk is stopped. One line per check, "ok" or "FAIL"; the exit
+//-- code is the number of failed checks. Build it with and without
+//-- __USE_US_ASYNC to check both ranging modes.
+
+#include <stdio.h>
+#include <Otto.h>
+#include "HostSim.h"
+#include "HostPins.h"
+
+#define WALK_STEPS        8
+#define WALK_T            1000
+#define GUARD_DISTANCE    200     //-- mm
+#define OBSTACLE_TIME     2300    //-- Obstacle appears (ms after the start)
+#define OBSTACLE_PHASES   12      //-- Obstacle times tried, OBSTACLE_SHIFT apart
+#define OBSTACLE_SHIFT    7       //-- ms
+#define REACTION_MAX      (US_PING_PERIOD + 20)   //-- One ping period and one servo frame (ms)
+
+Otto otto(PIN_LEG_L, PIN_LEG_R, PIN_FOOT_L, PIN_FOOT_R, PIN_NoiseSensor, PIN_Buzzer, PIN_Trigger, PIN_Echo);
+
+static uint64_t _motionEnd;
+
+static void _onMotionEnd()
+{
+    if (_motionEnd == 0) _motionEnd = HostSim::now();
+}
+
+/**
+ * @brief Guarded walk with an obstacle at echo us (0 = none) from time
+ *
+ * @param action    GUARD_xxx
+ * @param echo      Echo of the obstacle (us)
+ * @param time      Obstacle time (ms after the start)
+ * @param reaction  Time from the obstacle to the end of the walk (ms), -1 = none
+ * @return uint32_t Duration of the run (ms)
+ */
+static uint32_t _walk(uint8_t action, uint32_t echo, uint32_t time, long *reaction)
+{
+    //-- No obstacle left from the previous walk, pings included
+    HostSim::setEcho(PIN_Trigger, PIN_Echo, 0);
+    uint64_t start = HostSim::now();
+    while (HostSim::now() - start < 500000) otto.run();
+    _motionEnd = 0;
+
+    start = HostSim::now();
+    uint64_t obstacle = 0;
+    otto.walkGuarded(WALK_STEPS, WALK_T, FORWARD, GUARD_DISTANCE, action);
+    while (otto.run()) {
+        if ((obstacle == 0) && (echo > 0) && (HostSim::now() - start >= time * 1000ULL)) {
+            obstacle = HostSim::now();
+            HostSim::setEcho(PIN_Trigger, PIN_Echo, echo);
+        }
+    }
+    *reaction = (obstacle && (_motionEnd > obstacle)) ? (long)((_motionEnd - obstacle) / 1000) : -1;
+    return (HostSim::now() - start) / 1000;
+}
+
+/**
+ * @brief Reaction of a guarded walk to a close obstacle, at several times
+ * in the ping period
+ *
+ * @param name      Check name
+ * @param action    GUARD_xxx
+ * @param echo      Echo of the obstacle (us)
+ */
+static void _reaction(const char *name, uint8_t action, uint32_t echo)
+{
+    long reaction;
+    long sum = 0;
+    long worst = 0;
+    bool ok = true;
+
+    for (uint8_t i = 0; i < OBSTACLE_PHASES; i++) {
+        _walk(action, echo, OBSTACLE_TIME + i * OBSTACLE_SHIFT, &reaction);
+        if ((reaction < 0) || (reaction > REACTION_MAX)) ok = false;
+        if (reaction > worst) worst = reaction;
+        sum += reaction;
+    }
+    printf("     %s: mean reaction %ld ms\n", name, sum / OBSTACLE_PHASES);
+    HostSim::check(name, ok, worst);
+}
+
+int main()
+{
+    long reaction;
+    uint32_t time;
+
+    HostSim::reset();
+    otto.init(false);
+    otto.setBlocking(false);
+    otto.setMotionCallback(_onMotionEnd);
+
+    time = _walk(GUARD_STOP, 0, 0, &reaction);
+    HostSim::check("no obstacle: whole walk (ms)", time >= WALK_STEPS * WALK_T - MOTION_FRAME_TIME, time);
+
+    _reaction("GUARD_STOP worst reaction (ms)", GUARD_STOP, 1000);      //-- 172 mm
+    _reaction("GUARD_TURN worst reaction (ms)", GUARD_TURN, 1000);
+    _reaction("GUARD_SLOW close obstacle: worst reaction (ms)", GUARD_SLOW, 500);    //-- 86 mm
+
+    time = _walk(GUARD_SLOW, 1000, OBSTACLE_TIME, &reaction);
+    HostSim::check("GUARD_SLOW far obstacle: slower walk (ms)", time > WALK_STEPS * WALK_T + WALK_T, time);
+
+    time = _walk(GUARD_STOP, 1500, OBSTACLE_TIME, &reaction);     //-- 258 mm: beyond the distance
+    HostSim::check("obstacle beyond the distance: whole walk (ms)", time >= WALK_STEPS * WALK_T - MOTION_FRAME_TIME, time);
+
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        const OttoTaskState &state = otto.getTaskState(i);
+        printf("     task %u: max %u us, %u overruns, %u deferred\n", i, state.maxTime, state.overruns, state.deferred);
+    }
+
+    return HostSim::failed();
+}
@@ -0,0 +1,131 @@
+/**
+ * @file i2c.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host check of the I2C peripheral: commands, registers and STOP
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//-- The program plays the master with Wire.masterWrite / masterRead.
+//-- One line per check, "ok" or "FAIL"; the exit code is the number of
+//-- failed checks.
+
+#include <stdio.h>
+#include <OttoLee.h>
+#include <OttoI2C.h>
+#include "HostSim.h"
+#include "HostPins.h"
+
+#define I2C_ADDRESS       8
+
+OttoLee otto(PIN_LEG_L, PIN_LEG_R, PIN_FOOT_L, PIN_FOOT_R, PIN_ARM_L, PIN_ARM_R, PIN_HEAD, PIN_NoiseSensor, PIN_Buzzer, PIN_Trigger, PIN_Echo);
+OttoI2C<OttoLee> i2c(otto);
+
+//-- Master side
+static void _write(const uint8_t *frame, uint8_t length) {Wire.masterWrite(frame, length);}
+
+static uint8_t _read(uint8_t reg)
+{
+    uint8_t value;
+    Wire.masterWrite(&reg, 1);
+    Wire.masterRead(&value, 1);
+    return value;
+}
+
+//-- Main loop of the sketch for ms
+static void _loop(uint32_t ms)
+{
+    uint64_t end = HostSim::now() + (uint64_t)ms * 1000;
+    while (HostSim::now() < end) {
+        otto.run();
+        i2c.update();
+    }
+}
+
+static const uint8_t _walk[] = {I2C_CMD_GAIT, GAIT_WALK, 4, 0xE8, 0x03, 0, 1};    //-- 4 steps, T = 1000
+static const uint8_t _home[] = {I2C_CMD_HOME, 0xF4, 0x01};
+static const uint8_t _stop[] = {I2C_CMD_STOP};
+static const uint8_t _sing[] = {I2C_CMD_SING, S_mode1};
+static const uint8_t _song[] = {I2C_CMD_SING, SongSilentNight};
+static const uint8_t _invalid[] = {0x77, 1, 2};
+
+int main()
+{
+    HostSim::reset();
+    HostSim::setEcho(PIN_Trigger, PIN_Echo, 1160);     //-- Obstacle at 20cm
+    otto.init(false);
+    i2c.begin(I2C_ADDRESS);
+    _loop(100);
+
+    //-- Registers
+    HostSim::check("distance register (mm)", (_read(I2C_REG_DISTANCE) | (_read(I2C_REG_DISTANCE + 1) << 8)) == 200,
+        _read(I2C_REG_DISTANCE) | (_read(I2C_REG_DISTANCE + 1) << 8));
+    HostSim::check("free frames at rest", _read(I2C_REG_FRAME_FREE) == I2C_QUEUE_SIZE - 1, _read(I2C_REG_FRAME_FREE));
+
+    //-- Burst without update(): the frames beyond the queue are lost
+    for (uint8_t i = 0; i < I2C_QUEUE_SIZE + 2; i++) _write(_home, sizeof(_home));
+    HostSim::check("frames lost, queue full", i2c.getLost() == 3, i2c.getLost());
+    _loop(50);
+    HostSim::check("lost register", _read(I2C_REG_LOST) == 3, _read(I2C_REG_LOST));
+    _loop(5000);
+
+    //-- Invalid command
+    _write(_invalid, sizeof(_invalid));
+    _loop(50);
+    HostSim::check("invalid command counted", _read(I2C_REG_ERRORS) == 1, _read(I2C_REG_ERRORS));
+
+    //-- Motions wait for the motion queue, in order
+    for (uint8_t i = 0; i < 6; i++) _write(_walk, sizeof(_walk));
+    _loop(100);
+    HostSim::check("moving status", _read(I2C_REG_STATUS) & I2C_STATUS_MOVING, _read(I2C_REG_STATUS));
+    HostSim::check("motion frames waiting", _read(I2C_REG_FRAME_FREE) < I2C_QUEUE_SIZE - 1, (I2C_QUEUE_SIZE - 1) - _read(I2C_REG_FRAME_FREE));
+
+    //-- SING and STOP do not wait behind the motions. SING never holds
+    //-- update(): it is invalid without the tone timer, like the songs.
+    HostSim::clearEvents();
+    uint64_t start = HostSim::now();
+    _write(_sing, sizeof(_sing));
+    _write(_song, sizeof(_song));
+    _loop(20);
+    HostSim::check("sing: update() not held (ms)", HostSim::now() - start < 50000, (long)((HostSim::now() - start) / 1000));
+#ifdef __USE_TONE_TIMER
+    uint32_t sound = HostSim::count(HOST_EVENT_TONE) + HostSim::count(HOST_EVENT_PIN, PIN_Buzzer);
+    HostSim::check("sing behind blocked motions (sound events)", sound > 0, sound);
+    HostSim::check("song rejected", _read(I2C_REG_ERRORS) == 2, _read(I2C_REG_ERRORS));
+#else
+    HostSim::check("sing and song rejected without the tone timer", _read(I2C_REG_ERRORS) == 3, _read(I2C_REG_ERRORS));
+#endif
+    HostSim::check("no frame lost", i2c.getLost() == 3, i2c.getLost());
+    _loop(500);
+    _write(_stop, sizeof(_stop));
+    start = HostSim::now();
+    while (otto.isMoving() && (HostSim::now() - start < 5000000)) {
+        otto.run();
+        i2c.update();
+    }
+    HostSim::check("stop behind blocked motions (ms)", !otto.isMoving() && (HostSim::now() - start < 20000), (long)((HostSim::now() - start) / 1000));
+    _loop(200);
+    HostSim::check("still stopped 200 ms later", !otto.isMoving(), otto.isMoving());
+    HostSim::check("motion frames dropped", _read(I2C_REG_FRAME_FREE) == I2C_QUEUE_SIZE - 1, (I2C_QUEUE_SIZE - 1) - _read(I2C_REG_FRAME_FREE));
+
+    //-- A motion after STOP runs
+    _write(_walk, sizeof(_walk));
+    _loop(100);
+    HostSim::check("motion after stop", otto.isMoving(), otto.isMoving());
+
+    return HostSim::failed();
+}
@@ -0,0 +1,98 @@
+/**
+ * @file sound.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host check of the background sounds: sing() and r2d2() only queue
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//-- With the tone timer, the sounds are queued and played in the
+//-- background: each call must return at once, whatever the length of the
+//-- sound. One line per sound, "ok" or "FAIL"; the exit code is the number
+//-- of failed checks. A song must also go on during a blocking walk.
+
+#include <stdio.h>
+#include <Otto.h>
+#include "HostSim.h"
+#include "HostPins.h"
+
+#ifndef __USE_TONE_TIMER
+  #error "Build with -D__USE_TONE_TIMER: without it the sounds are played before returning"
+#endif
+
+#define RETURN_MAX        1000    //-- Longest time in the call (us)
+#define R2D2_RUNS         24      //-- r2d2() picks its phrases at random
+#define WALK_NOTES        8       //-- Fewest notes played during the walk
+
+Otto otto(PIN_LEG_L, PIN_LEG_R, PIN_FOOT_L, PIN_FOOT_R, PIN_NoiseSensor, PIN_Buzzer, PIN_Trigger, PIN_Echo);
+
+//-- Built-in sounds of sing()
+static const uint8_t _sounds[] = {
+    S_connection, S_disconnection, S_buttonPushed, S_mode1, S_mode2, S_mode3, S_surprise,
+    S_OhOoh, S_OhOoh2, S_cuddly, S_sleeping, S_happy, S_superHappy, S_happy_short, S_sad,
+    S_confused, S_fart1, S_fart2, S_fart3, SongSilentNight
+};
+
+/**
+ * @brief Time spent in the call, then play the sound to the end
+ *
+ * @param call      Time in the call (us)
+ * @return uint32_t Length of the sound (ms)
+ */
+static uint32_t _play(uint64_t start, uint64_t *call)
+{
+    *call = HostSim::now() - start;
+    while (otto.isSinging()) otto.updateSound();
+    return (HostSim::now() - start) / 1000;
+}
+
+int main()
+{
+    char name[48];
+    uint64_t call;
+    uint64_t worst = 0;
+
+    HostSim::reset();
+    otto.init(false);
+
+    for (uint8_t i = 0; i < sizeof(_sounds); i++) {
+        uint64_t start = HostSim::now();
+        otto.sing(_sounds[i]);
+        uint32_t length = _play(start, &call);
+        snprintf(name, sizeof(name), "sing(%u) of %lu ms: call (us)", _sounds[i], (unsigned long)length);
+        HostSim::check(name, call < RETURN_MAX, (long)call);
+    }
+
+    randomSeed(1);
+    for (uint8_t i = 0; i < R2D2_RUNS; i++) {
+        uint64_t start = HostSim::now();
+        otto.r2d2();
+        _play(start, &call);
+        if (call > worst) worst = call;
+    }
+    HostSim::check("r2d2(): longest call (us)", worst < RETURN_MAX, (long)worst);
+
+    //-- The queue holds less than a second of the song: the walk must feed it
+    HostSim::clearEvents();
+    otto.songTetris();
+    otto.walk(4, 1000, FORWARD);
+    uint16_t notes = HostSim::count(HOST_EVENT_TONE);
+    HostSim::check("songTetris() during walk(4): notes", notes >= WALK_NOTES, notes);
+    otto.stopSound();
+
+    return HostSim::failed();
+}
@@ -0,0 +1,145 @@
+/**
+ * @file stream.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Host check of the joint streaming: latency and jitter buffer
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//-- The program plays the PC: one packet per STREAM_FRAME_TIME, each one
+//-- late by a pseudo-random jitter. The latency of a packet is the time
+//-- from its nominal send time to the servo write of its positions.
+//-- One line per check, "ok" or "FAIL"; the exit code is the number of
+//-- failed checks.
+
+#include <stdio.h>
+#include <Otto.h>
+#include <OttoStream.h>
+#include "HostSim.h"
+#include "HostPins.h"
+
+#define PACKETS           500
+#define LATENCY_MAX       (STREAM_PREFILL * STREAM_FRAME_TIME)    //-- ms
+
+Otto otto(PIN_LEG_L, PIN_LEG_R, PIN_FOOT_L, PIN_FOOT_R, PIN_NoiseSensor, PIN_Buzzer, PIN_Trigger, PIN_Echo);
+OttoStream<4> stream(otto, Serial);
+
+static uint32_t _seed;
+
+//-- Reproducible jitter, 0 to max ms
+static uint32_t _jitter(uint32_t max)
+{
+    _seed = _seed * 1103515245UL + 12345;
+    return ((_seed >> 16) & 0x7FFF) % (max + 1);
+}
+
+//-- Position of the left leg in packet k: each one differs from the previous
+static uint8_t _position(uint16_t k) {return 20 + (k % 140);}
+
+/**
+ * @brief Stream PACKETS packets and measure their latency
+ *
+ * @param jitter    Largest delay of a packet (ms)
+ * @param period    Send period of the PC (us)
+ * @param min       Shortest latency (ms)
+ * @param max       Longest latency (ms)
+ * @return uint16_t Packets played
+ */
+static uint16_t _stream(uint32_t jitter, uint32_t period, long *min, long *max)
+{
+    static uint64_t send[PACKETS];
+    static uint64_t arrival[PACKETS];
+
+    stream.begin();
+    stream.resetStats();
+    HostSim::clearEvents();
+    _seed = 1;
+
+    uint64_t start = HostSim::now();
+    for (uint16_t k = 0; k < PACKETS; k++) {
+        send[k] = start + (uint64_t)k * period;
+        arrival[k] = send[k] + _jitter(jitter) * 1000;
+        //-- The packets stay in order
+        if ((k > 0) && (arrival[k] < arrival[k - 1])) arrival[k] = arrival[k - 1];
+    }
+
+    uint16_t next = 0;
+    //-- Until the last packet is played: the next tick would be an underrun
+    while (((next < PACKETS) || (stream.getLevel() > 0)) && (HostSim::now() < arrival[PACKETS - 1] + 1000000)) {
+        while ((next < PACKETS) && (HostSim::now() >= arrival[next])) {
+            uint8_t packet[6] = {STREAM_SYNC, _position(next), 90, 90, 90, 0};
+            packet[5] = (packet[1] + 270) % 255;
+            HostSim::serialInput(packet, sizeof(packet));
+            next++;
+        }
+        otto.run();
+        stream.update();
+    }
+    stream.end();
+
+    //-- Latency of each packet played, from the servo writes of the left leg
+    uint16_t played = 0;
+    uint16_t k = 0;
+    *min = 0x7FFFFFFF;
+    *max = 0;
+    const std::vector<HostEvent> &events = HostSim::events();
+    for (size_t i = 0; i < events.size(); i++) {
+        const HostEvent &event = events[i];
+        if ((event.type != HOST_EVENT_SERVO) || (event.pin != PIN_LEG_L)) continue;
+        //-- The packet written, the dropped ones skipped
+        uint16_t j = k;
+        while ((j < PACKETS) && (j < k + STREAM_BUFFER_SIZE) && ((event.value != _position(j)) || (event.time < arrival[j]))) j++;
+        if ((j >= PACKETS) || (j >= k + STREAM_BUFFER_SIZE)) continue;
+        k = j;
+        long latency = (long)((event.time - send[k]) / 1000);
+        if (latency < *min) *min = latency;
+        if (latency > *max) *max = latency;
+        played++;
+        k++;
+    }
+    return played;
+}
+
+int main()
+{
+    long min, max;
+    uint16_t played;
+
+    HostSim::reset();
+    HostSim::record(HOST_EVENT_SERVO);
+    otto.init(false);
+    otto.setBlocking(false);
+
+    //-- PC at the frame rate, 15 ms of jitter
+    played = _stream(15, STREAM_FRAME_TIME * 1000UL, &min, &max);
+    const OttoStreamStats &stats = stream.getStats();
+    printf("     jitter 15 ms: latency %ld to %ld ms\n", min, max);
+    HostSim::check("jitter 15 ms: packets played", played == PACKETS, played);
+    HostSim::check("jitter 15 ms: underruns", stats.underruns == 0, stats.underruns);
+    HostSim::check("jitter 15 ms: overruns", stats.overruns == 0, stats.overruns);
+    HostSim::check("jitter 15 ms: invalid packets", stats.errors == 0, stats.errors);
+    HostSim::check("jitter 15 ms: constant latency, spread (ms)", max - min <= 1, max - min);
+    HostSim::check("jitter 15 ms: latency within the prefill (ms)", max <= LATENCY_MAX, max);
+
+    //-- PC clock 1% fast: the oldest frames are dropped, the latency stays bounded
+    played = _stream(15, STREAM_FRAME_TIME * 990UL, &min, &max);
+    printf("     fast clock: latency %ld to %ld ms, %u overruns\n", min, max, stats.overruns);
+    HostSim::check("fast clock: underruns", stats.underruns == 0, stats.underruns);
+    HostSim::check("fast clock: latency bounded (ms)", max <= STREAM_LEVEL_MAX * STREAM_FRAME_TIME + STREAM_FRAME_TIME, max);
+
+    return HostSim::failed();
+}
@@ -12,11 +12,52 @@
   #include <pins_arduino.h>
 #endif
 #include "Oscillator.h"
-#include <Servo.h>
+
+#ifndef __USE_OSC_FLOAT_MATH
+//-- Quarter-wave sine table: sin(i * PI/128) for i = 0..64, Q15
+const PROGMEM int16_t _sinQuarterTable[65] = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+     6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767
+};
+#endif
+
+//-- Fixed-point sine of a phase (full turn = 65536)
+//-- The quarter-wave table is linearly interpolated
+//-- Returns a Q15 value (32767 = 1.0)
+int16_t Oscillator::sinQ15(uint16_t phase)
+{
+#ifdef __USE_OSC_FLOAT_MATH
+  return (int16_t)(32767 * sin(phase * (2 * M_PI / OSC_PHASE_TURN)));
+#else
+  //-- Fold the phase into the first quadrant (0 to 0x4000)
+  uint16_t x = phase & 0x3FFF;
+  if (phase & 0x4000) x = 0x4000 - x;
+
+  uint8_t idx = x >> 8;
+  uint8_t frac = x & 0xFF;
+  int16_t y = pgm_read_word(&_sinQuarterTable[idx]);
+  if (frac) {
+    int16_t y1 = pgm_read_word(&_sinQuarterTable[idx + 1]);
+    y += (int16_t)(((int32_t)(y1 - y) * frac) >> 8);
+  }
+
+  //-- Second half of the turn is negative
+  return (phase & 0x8000) ? -y : y;
+#endif
+}
 
 //-- This function returns true if another sample
 //-- should be taken (i.e. the TS time has passed since
 //-- the last sample was taken
+//-- The samples stay on the TS grid: when the call is late,
+//-- the missed samples are skipped and the grid is kept
 bool Oscillator::next_sample()
 {
   
@@ -24,8 +65,15 @@ bool Oscillator::next_sample()
   _currentMillis = millis();
  
   //-- Check if the timeout has passed
-  if(_currentMillis - _previousMillis > _TS) {
-    _previousMillis = _currentMillis;   
+  uint32_t elapsed = _currentMillis - _previousMillis;
+  if(elapsed >= _TS) {
+    _previousMillis += elapsed - (elapsed % _TS);
+#ifdef __USE_OSC_STATS
+    uint32_t late = elapsed % _TS;
+    uint32_t missed = elapsed / _TS - 1;
+    _late = (late > 255) ? 255 : late;
+    _missed = (missed > 255) ? 255 : missed;
+#endif
 
     return true;
   }
@@ -33,29 +81,77 @@ bool Oscillator::next_sample()
   return false;
 }
 
+#ifdef __USE_OSC_STATS
+//-- Clear the sampling statistics
+void OscStats::reset()
+{
+  for (uint8_t i = 0; i < OSC_STATS_BINS; i++) _histogram[i] = 0;
+  _max = 0;
+  _sum = 0;
+  _samples = 0;
+  _missed = 0;
+}
+
+//-- Record a sample: lateness versus its scheduled time (ms)
+//-- and number of samples skipped before it
+void OscStats::add(uint8_t late, uint8_t missed)
+{
+  uint8_t bin = late / OSC_STATS_BIN_MS;
+  if (bin >= OSC_STATS_BINS) bin = OSC_STATS_BINS - 1;
+  if (_histogram[bin] < 0xFFFF) _histogram[bin]++;
+  if (late > _max) _max = late;
+  _sum += late;
+  _samples++;
+  _missed += missed;
+}
+
+//-- Mean lateness of the samples (us)
+uint32_t OscStats::getMean()
+{
+  if (_samples == 0) return 0;
+  return (_sum / _samples) * 1000 + ((_sum % _samples) * 1000) / _samples;
+}
+#endif
+
+//-- Output a position to the servo
+//-- With ServoTimer, the position is only staged until
+//-- the frame is committed
+void Oscillator::write(int angle)
+{
+#ifdef __USE_SERVO_TIMER
+  ServoTimer::write(_channel, angle);
+#else
+  _servo.write(angle);
+#endif
+}
+
 //-- Attach an oscillator to a servo
 //-- Input: pin is the arduino pin were the servo
 //-- is connected
 void Oscillator::attach(int pin, bool rev)
 {
   //-- If the oscillator is detached, attach it.
+#ifdef __USE_SERVO_TIMER
+  if(!ServoTimer::attached(_channel)){
+
+    //-- Attach the servo and move it to the home position
+      _channel = ServoTimer::attach(pin);
+#else
   if(!_servo.attached()){
 
     //-- Attach the servo and move it to the home position
       _servo.attach(pin);
-      _servo.write(90);
+#endif
+      write(90);
+      _pos = 0;
 
       //-- Initialization of oscilaltor parameters
       _TS=30;
-      _T=2000;
-      _N = _T/_TS;
-      _inc = 2*M_PI/_N;
-
-      _previousMillis=0;
+      SetT(2000);
 
       //-- Default parameters
       _A=45;
-      _phase=0;
+      Reset();
       _phase0=0;
       _O=0;
       _stop=false;
@@ -70,8 +166,15 @@ void Oscillator::attach(int pin, bool rev)
 void Oscillator::detach()
 {
    //-- If the oscillator is attached, detach it.
+#ifdef __USE_SERVO_TIMER
+  if(ServoTimer::attached(_channel)) {
+        ServoTimer::detach(_channel);
+        _channel = SERVO_TIMER_INVALID;
+  }
+#else
   if(_servo.attached())
         _servo.detach();
+#endif
 
 }
 
@@ -83,18 +186,96 @@ void Oscillator::SetT(uint16_t T)
   //-- Assign the new period
   _T=T;
   
-  //-- Recalculate the parameters
-  _N = _T/_TS;
-  _inc = 2*M_PI/_N;
+  //-- Recalculate the phase increment: round(2^32 / T) per ms
+  //-- The phase already reached is kept, so the change is continuous
+  uint16_t period = (_T > 0) ? _T : 1;
+  _inc = 0xFFFFFFFFUL / period;
+  uint32_t remainder = 0xFFFFFFFFUL % period + 1;
+  if (2 * remainder >= period) _inc++;
 };
 
+/*******************************************/
+/* Restart the oscillation at phase 0      */
+/* t0 is the start time of the oscillation */
+/* (use the same t0 to lock several osc.)  */
+/*******************************************/
+void Oscillator::Reset()
+{
+  Reset(millis());
+}
+
+void Oscillator::Reset(uint32_t t0)
+{
+  _phase = 0;
+  _blendTime = 0;
+  _phaseTime = t0;
+  //-- First sample at t0, then every TS ms
+  _previousMillis = t0 - _TS;
+}
+
+/*************************************/
+/* Set the oscillator phase, in rad  */
+/*************************************/
+void Oscillator::SetPh(double Ph)
+{
+  //-- Negative and multi-turn phases wrap around naturally
+  _phase0 = RAD2PHASE(Ph);
+};
+
+/*********************************************/
+/* Set the oscillator phase, 65536 = 1 turn  */
+/*********************************************/
+void Oscillator::SetPhase(uint16_t phase)
+{
+  _phase0 = phase;
+};
+
+/*************************************************************/
+/* Start a smooth transition at time t: the parameters set   */
+/* after this call (A, O, T, phase) are reached in time ms.  */
+/* The phase stays continuous during the transition          */
+/*************************************************************/
+void Oscillator::StartBlend(uint32_t t, uint16_t time)
+{
+  //-- Start from the current parameters, even during a transition
+  uint16_t k = blendFactor(t);
+  if (k < 256) {
+    _blendA = _blendA + (int16_t)(((int32_t)(_A - _blendA) * k) >> 8);
+    _blendO = _blendO + (int16_t)(((int32_t)(_O - _blendO) * k) >> 8);
+    _blendPhase0 = _blendPhase0 + (int16_t)(((int32_t)(int16_t)(_phase0 - _blendPhase0) * k) >> 8);
+    _blendInc = _blendInc + ((int32_t)(_inc - _blendInc) >> 8) * k;
+  }
+  else {
+    _blendA = _A;
+    _blendO = _O;
+    _blendPhase0 = _phase0;
+    _blendInc = _inc;
+  }
+
+  _blendStart = t;
+  _blendTime = time;
+  _blendRate = (time > 0) ? (uint16_t)(65535UL / time) : 0;
+}
+
+//-- Progress of the transition at time t: 0 (start) to 256 (done)
+uint16_t Oscillator::blendFactor(uint32_t t)
+{
+  if (_blendTime == 0) return 256;
+  uint32_t dt = t - _blendStart;
+  if (dt >= _blendTime) {
+    _blendTime = 0;
+    return 256;
+  }
+  return (uint16_t)((dt * _blendRate) >> 8);
+}
+
 /*******************************/
 /* Manual set of the position  */
 /******************************/
 
 void Oscillator::SetPosition(uint8_t position)
 {
-  _servo.write(position+_trim);
+  write(position+_trim);
 };
 
 
@@ -102,24 +283,48 @@ void Oscillator::SetPosition(uint8_t position)
 /* This function should be periodically called                     */
 /* in order to maintain the oscillations. It calculates            */
 /* if another sample should be taken and position the servo if so  */
+/* Returns true if a new sample was taken                          */
 /*******************************************************************/
-void Oscillator::refresh()
+bool Oscillator::refresh()
 {
   
   //-- Only When TS milliseconds have passed, the new sample is obtained
   if (next_sample()) {
   
+      int16_t A = _A;
+      int16_t O = _O;
+      uint16_t phase0 = _phase0;
+      uint32_t inc = _inc;
+
+      //-- During a transition, interpolate from the previous parameters
+      //-- (the phase offset takes the shortest way)
+      uint16_t k = blendFactor(_previousMillis);
+      if (k < 256) {
+        A = _blendA + (int16_t)(((int32_t)(_A - _blendA) * k) >> 8);
+        O = _blendO + (int16_t)(((int32_t)(_O - _blendO) * k) >> 8);
+        phase0 = _blendPhase0 + (int16_t)(((int32_t)(int16_t)(_phase0 - _blendPhase0) * k) >> 8);
+        inc = _blendInc + ((int32_t)(_inc - _blendInc) >> 8) * k;
+      }
+
+      //-- The phase is computed from the time of the sample:
+      //-- phase = 2*PI*(t - t0)/T, whatever the call rate is
+      _phase += (_previousMillis - _phaseTime) * inc;
+      _phaseTime = _previousMillis;
+
       //-- If the oscillator is not stopped, calculate the servo position
+      //-- The phase is always increased, even when the oscillator is stop
+      //-- so that the coordination is always kept
       if (!_stop) {
         //-- Sample the sine function and set the servo pos
-         _pos = round(_A * sin(_phase + _phase0) + _O);
+#ifdef __USE_OSC_FLOAT_MATH
+         _pos = round(A * sin((_phase + ((uint32_t)phase0 << 16)) * (2 * M_PI / 4294967296.0)) + O);
+#else
+         _pos = (int16_t)(((int32_t)A * sinQ15((uint16_t)(_phase >> 16) + phase0) + 0x4000) >> 15) + O;
+#endif
 	       if (_rev) _pos=-_pos;
-         _servo.write(_pos+90+_trim);
+         write(_pos+90+_trim);
       }
-
-      //-- Increment the phase
-      //-- It is always increased, even when the oscillator is stop
-      //-- so that the coordination is always kept
-      _phase = _phase + _inc;
+      return true;
   }
+  return false;
 }
\ No newline at end of file
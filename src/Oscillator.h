@@ -9,55 +9,135 @@
 #define Oscillator_h
 
 #include <stdint.h>
-#include <Servo.h>
+#include "ServoTimer.h"
+#ifndef __USE_SERVO_TIMER
+  #include <Servo.h>
+#endif
 
 //-- Macro for converting from degrees to radians
 #ifndef DEG2RAD
   #define DEG2RAD(g) ((g)*M_PI)/180
 #endif
 
+//-- Configuration
+//-- Uncomment to compute the servo position with the floating point sin()
+//-- instead of the fixed-point sine table
+// #define __USE_OSC_FLOAT_MATH      1
+
+//-- Fixed-point phase: a full turn (2*PI) is 65536
+#define OSC_PHASE_TURN    65536UL
+
+//-- Macros for converting from radians / degrees to fixed-point phase
+#define RAD2PHASE(r)  ((uint16_t)(int32_t)((r) * (OSC_PHASE_TURN / (2 * M_PI))))
+#define DEG2PHASE(g)  ((uint16_t)(((int32_t)(g) * 46603L) >> 8))
+
+//-- Uncomment to measure how late the samples are taken (see OscStats)
+// #define __USE_OSC_STATS           1
+#define OSC_STATS_BINS      8   //-- Lateness histogram: number of bins
+#define OSC_STATS_BIN_MS    2   //-- Lateness histogram: width of a bin (ms)
+
+#ifdef __USE_OSC_STATS
+//-- Sampling statistics: lateness of the samples versus the TS schedule
+class OscStats
+{
+  public:
+    OscStats() {reset();};
+    void reset();
+    void add(uint8_t late, uint8_t missed);
+    uint16_t getHistogram(uint8_t bin) {return (bin < OSC_STATS_BINS) ? _histogram[bin] : 0;};
+    uint8_t getMax() {return _max;};
+    uint32_t getMean();
+    uint32_t getSamples() {return _samples;};
+    uint32_t getMissed() {return _missed;};
+
+  private:
+    uint16_t _histogram[OSC_STATS_BINS]; //-- Samples per lateness range (the last bin is open)
+    uint8_t _max;                        //-- Maximum lateness (ms)
+    uint32_t _sum;                       //-- Sum of the lateness (ms)
+    uint32_t _samples;                   //-- Samples taken
+    uint32_t _missed;                    //-- Samples skipped because the call was too late
+};
+#endif
+
 class Oscillator
 {
   public:
+#ifdef __USE_SERVO_TIMER
+    Oscillator(int trim=0) {_trim=trim; _channel=SERVO_TIMER_INVALID;};
+#else
     Oscillator(int trim=0) {_trim=trim;};
+#endif
     void attach(int pin, bool rev =false);
     void detach();
     
     void SetA(int16_t A) {_A=A;};
     void SetO(int16_t O) {_O=O;};
-    void SetPh(double Ph) {_phase0=Ph;};
+    void SetPh(double Ph);
+    void SetPhase(uint16_t phase);
     void SetT(uint16_t T);
     void SetTrim(int8_t trim){_trim=trim;};
     int8_t getTrim() {return _trim;};
     void SetPosition(uint8_t position); 
     void Stop() {_stop=true;};
     void Play() {_stop=false;};
-    void Reset() {_phase=0;};
-    void refresh();
+    void Reset();
+    void Reset(uint32_t t0);
+    void StartBlend(uint32_t t, uint16_t time);
+    bool refresh();
+    uint32_t getNextSample() {return _previousMillis + _TS;};
+    uint8_t getPosition() {return _pos + 90;};
+
+    //-- Fixed-point sine: phase (full turn = 65536) -> Q15
+    static int16_t sinQ15(uint16_t phase);
+
+#ifdef __USE_OSC_STATS
+    //-- Lateness of the last sample (ms) and samples skipped before it
+    uint8_t getLate() {return _late;};
+    uint8_t getMissed() {return _missed;};
+#endif
     
   private:
     bool next_sample();  
+    void write(int angle);
+    uint16_t blendFactor(uint32_t t);
     
   private:
     //-- Servo that is attached to the oscillator
+#ifdef __USE_SERVO_TIMER
+    uint8_t _channel;
+#else
     Servo _servo;
+#endif
     
     //-- Oscillators parameters
     int16_t _A;  //-- Amplitude (degrees)
     int16_t _O;  //-- Offset (degrees)
     uint16_t _T;  //-- Period (miliseconds)
-    double _phase0;   //-- Phase (radians)
+    uint16_t _phase0; //-- Phase (1/65536 turn)
     
     //-- Internal variables
     int16_t _pos;         //-- Current servo pos
     int8_t _trim;        //-- Calibration offset
-    double _phase;    //-- Current phase
-    double _inc;      //-- Increment of phase
-    double _N;        //-- Number of samples
+    uint32_t _phase;      //-- Current phase (1/2^32 turn)
+    uint32_t _inc;        //-- Increment of phase per ms (1/2^32 turn)
+    uint32_t _phaseTime;  //-- Time of the current phase (ms)
     uint16_t _TS; //-- sampling period (ms)
     
-    uint32_t _previousMillis; 
+    //-- Transition (crossfade) from the previous parameters
+    uint16_t _blendTime;    //-- Duration of the transition (ms), 0 = none
+    uint16_t _blendRate;    //-- 65536 / _blendTime
+    uint32_t _blendStart;   //-- Start time of the transition (ms)
+    int16_t _blendA;        //-- Amplitude at the start of the transition
+    int16_t _blendO;        //-- Offset at the start of the transition
+    uint16_t _blendPhase0;  //-- Phase at the start of the transition
+    uint32_t _blendInc;     //-- Phase increment at the start of the transition
+
+    uint32_t _previousMillis; //-- Time of the last sample, on the TS grid
     uint32_t _currentMillis;
+#ifdef __USE_OSC_STATS
+    uint8_t _late;
+    uint8_t _missed;
+#endif
     
     //-- Oscillation mode. If true, the servo is stopped
     bool _stop;
@@ -23,7 +23,7 @@
 #include <Otto.h>
 
 Otto::Otto(uint8_t legLeft, uint8_t legRight, uint8_t footLeft, uint8_t footRight, uint8_t pinNoiseSensor, uint8_t pinBuzzer, uint8_t pinUSTrigger, uint8_t pinUSEcho) : 
-    OttoSound(pinBuzzer), OttoSensor(pinNoiseSensor), OttoServo()
+    OttoRobot(pinBuzzer, pinNoiseSensor)
 {
     uint8_t servoPin[_NBR_OF_SERVO];
 
@@ -58,10 +58,8 @@ void Otto::init(bool load_calibration)
  */
 void Otto::jump(float steps, uint16_t T)
 {
-    uint8_t up[_NBR_OF_SERVO]={90,90,150,30};
-    moveServos(T,up);
-    uint8_t down[_NBR_OF_SERVO]={90,90,90,90};
-    moveServos(T,down);
+    //-- Up and down, T each
+    playKeyframes(keyframes_jump, KEYFRAME_COUNT(keyframes_jump), T);
 }
 
 /**
@@ -81,12 +79,8 @@ void Otto::walk(float steps, uint16_t T, int8_t dir)
     //--       90 : Walk backward
     //-- Feet servos also have the same offset (for tiptoe a little bit)
 
-    int16_t A[_NBR_OF_SERVO]= {30, 30, 20, 20};
-    int16_t O[_NBR_OF_SERVO] = {0, 0, 4, -4};
-    double phase_diff[_NBR_OF_SERVO] = {0, 0, DEG2RAD(dir * -90), DEG2RAD(dir * -90)};
-
     //-- Let's oscillate the servos!
-    execute(A, O, T, phase_diff, steps);  
+    executeGait(&gait_walk, steps, T, 0, dir);
 }
 
 /**
@@ -103,21 +97,8 @@ void Otto::turn(float steps, uint16_t T, int8_t dir)
     //-- When the right hip servo amplitude is higher, the steps taken by
     //--   the right leg are bigger than the left. So, the robot describes an 
     //--   left arc
-    int16_t A[_NBR_OF_SERVO]= {30, 30, 20, 20};
-    int16_t O[_NBR_OF_SERVO] = {0, 0, 4, -4};
-    double phase_diff[_NBR_OF_SERVO] = {0, 0, DEG2RAD(-90), DEG2RAD(-90)}; 
-        
-    if (dir == LEFT) {  
-        A[0] = 30; //-- Left hip servo
-        A[1] = 10; //-- Right hip servo
-    }
-    else {
-        A[0] = 10;
-        A[1] = 30;
-    }
-        
     //-- Let's oscillate the servos!
-    execute(A, O, T, phase_diff, steps); 
+    executeGait((dir == LEFT) ? &gait_turn_left : &gait_turn_right, steps, T);
 }
 
 /**
@@ -129,32 +110,10 @@ void Otto::turn(float steps, uint16_t T, int8_t dir)
  */
 void Otto::bend(uint16_t steps, uint16_t T, int8_t dir)
 {
-    //Parameters of all the movements. Default: Left bend
-    uint8_t bend1[_NBR_OF_SERVO]={90, 90, 62, 35}; 
-    uint8_t bend2[_NBR_OF_SERVO]={90, 90, 62, 105};
-    uint8_t homes[_NBR_OF_SERVO]={90, 90, 90, 90};
-
-    //Time of one bend, constrained in order to avoid movements too fast.
-    //T=max(T, 600);
-
-    //Changes in the parameters if right direction is chosen 
-    if(dir==-1) {
-        bend1[2]=180-35;
-        bend1[3]=180-60;  //Not 65. Otto is unbalanced
-        bend2[2]=180-105;
-        bend2[3]=180-60;
-    }
-
-    //Time of the bend movement. Fixed parameter to avoid falls
-    uint16_t T2=800; 
-
-    //Bend movement
-    for (uint16_t i=0;i<steps;i++) {
-        moveServos(T2/2,bend1);
-        moveServos(T2/2,bend2);
-        delay(T*0.8);
-        moveServos(500,homes);
-    }
+    //-- Fixed bend time (800ms) to avoid falls, then hold during 0.8T
+    //-- The right bend is not symmetrical: Otto is unbalanced
+    if(dir==-1) playKeyframes(keyframes_bend_right, KEYFRAME_COUNT(keyframes_bend_right), T, steps);
+    else playKeyframes(keyframes_bend_left, KEYFRAME_COUNT(keyframes_bend_left), T, steps);
 }
 
 
@@ -167,45 +126,18 @@ void Otto::bend(uint16_t steps, uint16_t T, int8_t dir)
  */
 void Otto::shakeLeg(uint16_t steps, uint16_t T, int8_t dir)
 {
-    //This variable change the amount of shakes
-    uint16_t numberLegMoves=2;
-
-    //Parameters of all the movements. Default: Right leg
-    uint8_t shake_leg1[_NBR_OF_SERVO]={90, 90, 58, 35};   
-    uint8_t shake_leg2[_NBR_OF_SERVO]={90, 90, 58, 120};
-    uint8_t shake_leg3[_NBR_OF_SERVO]={90, 90, 58, 60};
-    uint8_t homes[_NBR_OF_SERVO]={90, 90, 90, 90};
-
-    //Changes in the parameters if left leg is chosen
-    if(dir==-1) {
-        shake_leg1[2]=180-35;
-        shake_leg1[3]=180-58;
-        shake_leg2[2]=180-120;
-        shake_leg2[3]=180-58;
-        shake_leg3[2]=180-60;
-        shake_leg3[3]=180-58;
-    }
-  
     //Time of the bend movement. Fixed parameter to avoid falls
     uint16_t T2=2000;    
-    //Time of one shake, constrained in order to avoid movements too fast.            
+    //Time of the 2 shakes, constrained in order to avoid movements too fast.            
     T=T-T2;
-    T=max(T,200*numberLegMoves);  
+    T=max(T,400);  
 
-    for (uint16_t j=0; j<steps;j++) {
-        //Bend movement
-        moveServos(T2/2,shake_leg1);
-        moveServos(T2/2,shake_leg2);
-        //Shake movement
-        for (uint16_t i=0;i<numberLegMoves;i++)
-        {
-        moveServos(T/(2*numberLegMoves),shake_leg3);
-        moveServos(T/(2*numberLegMoves),shake_leg2);
-        }
-        moveServos(500,homes); //Return to home position
-    }
-    
-    delay(T);
+    //-- Bend (T2), shakes (T/4 each) and return to home position
+    if(dir==-1) playKeyframes(keyframes_shake_leg_left, KEYFRAME_COUNT(keyframes_shake_leg_left), T, steps);
+    else playKeyframes(keyframes_shake_leg_right, KEYFRAME_COUNT(keyframes_shake_leg_right), T, steps);
+
+    //-- Rest during T
+    playKeyframes(keyframes_rest_hold, KEYFRAME_COUNT(keyframes_rest_hold), T);
 }
 
 /**
@@ -221,12 +153,8 @@ void Otto::updown(float steps, uint16_t T, int16_t h)
     //-- Feet amplitude and offset are the same
     //-- Initial phase for the right foot is -90, so that it starts
     //--   in one extreme position (not in the middle)
-    int16_t A[_NBR_OF_SERVO]= {0, 0, h, h};
-    int16_t O[_NBR_OF_SERVO] = {0, 0, h, -h};
-    double phase_diff[_NBR_OF_SERVO] = {0, 0, DEG2RAD(-90), DEG2RAD(90)};
-    
     //-- Let's oscillate the servos!
-    execute(A, O, T, phase_diff, steps); 
+    executeGait(&gait_updown, steps, T, h);
 }
 
 /**
@@ -240,12 +168,8 @@ void Otto::swing(float steps, uint16_t T, int16_t h)
 {
     //-- Both feets are in phase. The offset is half the amplitude
     //-- It causes the robot to swing from side to side
-    int16_t A[_NBR_OF_SERVO]= {0, 0, h, h};
-    int16_t O[_NBR_OF_SERVO] = {0, 0, h/2, -h/2};
-    double phase_diff[_NBR_OF_SERVO] = {0, 0, DEG2RAD(0), DEG2RAD(0)};
-    
     //-- Let's oscillate the servos!
-    execute(A, O, T, phase_diff, steps); 
+    executeGait(&gait_swing, steps, T, h);
 }
 
 /**
@@ -259,12 +183,8 @@ void Otto::tiptoeSwing(float steps, uint16_t T, int16_t h){
 
     //-- Both feets are in phase. The offset is not half the amplitude in order to tiptoe
     //-- It causes the robot to swing from side to side
-    int16_t A[_NBR_OF_SERVO]= {0, 0, h, h};
-    int16_t O[_NBR_OF_SERVO] = {0, 0, h, -h};
-    double phase_diff[_NBR_OF_SERVO] = {0, 0, 0, 0};
-    
     //-- Let's oscillate the servos!
-    execute(A, O, T, phase_diff, steps); 
+    executeGait(&gait_tiptoe_swing, steps, T, h);
 }
 
 /**
@@ -282,12 +202,8 @@ void Otto::jitter(float steps, uint16_t T, int16_t h)
     //--   in one extreme position (not in the middle)
     //-- h is constrained to avoid hit the feets
     h = min(25,h);
-    int16_t A[_NBR_OF_SERVO]= {h, h, 0, 0};
-    int16_t O[_NBR_OF_SERVO] = {0, 0, 0, 0};
-    double phase_diff[_NBR_OF_SERVO] = {DEG2RAD(-90), DEG2RAD(90), 0, 0};
-    
     //-- Let's oscillate the servos!
-    execute(A, O, T, phase_diff, steps); 
+    executeGait(&gait_jitter, steps, T, h);
 }
 
 /**
@@ -304,12 +220,8 @@ void Otto::ascendingTurn(float steps, uint16_t T, int16_t h)
     //--   in one extreme position (not in the middle)
     //-- h is constrained to avoid hit the feets
     h = min(13,h);
-    int16_t A[_NBR_OF_SERVO] = {h, h, h, h};
-    int16_t O[_NBR_OF_SERVO] = {0, 0, h+4, -h+4};
-    double phase_diff[_NBR_OF_SERVO] = {DEG2RAD(-90), DEG2RAD(90), DEG2RAD(-90), DEG2RAD(90)};
-    
     //-- Let's oscillate the servos!
-    execute(A, O, T, phase_diff, steps); 
+    executeGait(&gait_ascending_turn, steps, T, h);
 }
 
 /**
@@ -332,13 +244,8 @@ void Otto::moonwalker(float steps, uint16_t T, int16_t h, int dir)
     //--  Both amplitudes are equal. The offset is half the amplitud plus a little bit of
     //-   offset so that the robot tiptoe lightly
     
-    int16_t A[_NBR_OF_SERVO] = {0, 0, h, h};
-    int16_t O[_NBR_OF_SERVO] = {0, 0, h/2+2, -h/2 -2};
-    int phi = -dir * 90;
-    double phase_diff[_NBR_OF_SERVO] = {0, 0, DEG2RAD(phi), DEG2RAD(-60 * dir + phi)};
-    
     //-- Let's oscillate the servos!
-    execute(A, O, T, phase_diff, steps); 
+    executeGait(&gait_moonwalker, steps, T, h, dir);
 }
 
 /**
@@ -351,12 +258,8 @@ void Otto::moonwalker(float steps, uint16_t T, int16_t h, int dir)
  */
 void Otto::crusaito(float steps, uint16_t T, int16_t h, int dir)
 {
-    int16_t A[_NBR_OF_SERVO]= {25, 25, h, h};
-    int16_t O[_NBR_OF_SERVO] = {0, 0, h/2+ 4, -h/2 - 4};
-    double phase_diff[_NBR_OF_SERVO] = {90, 90, DEG2RAD(0), DEG2RAD(-60 * dir)};
-    
     //-- Let's oscillate the servos!
-    execute(A, O, T, phase_diff, steps); 
+    executeGait(&gait_crusaito, steps, T, h, dir);
 }
 
 /**
@@ -369,10 +272,6 @@ void Otto::crusaito(float steps, uint16_t T, int16_t h, int dir)
  */
 void Otto::flapping(float steps, uint16_t T, int16_t h, int dir)
 {
-    int16_t A[_NBR_OF_SERVO]= {12, 12, h, h};
-    int16_t O[_NBR_OF_SERVO] = {0, 0, h - 10, -h + 10};
-    double phase_diff[_NBR_OF_SERVO] = {DEG2RAD(0), DEG2RAD(180), DEG2RAD(-90 * dir), DEG2RAD(90 * dir)};
-    
     //-- Let's oscillate the servos!
-    execute(A, O, T, phase_diff, steps); 
+    executeGait(&gait_flapping, steps, T, h, dir);
 }
@@ -24,17 +24,13 @@
 #define OTTO_h
 
 #include "OttoGlobal.h"
-#include "OttoSound.h"
-#include "OttoSensor.h"
-#include "OttoServo.h"
+#include "OttoRobot.h"
 
 #define _NBR_OF_SERVO   4
 
 
-class Otto: public OttoSound, public OttoSensor, public OttoServo<_NBR_OF_SERVO>
+class Otto: public OttoRobot<Otto, _NBR_OF_SERVO>
 {
-    private:
-        /* data */
     public:
         Otto(uint8_t legLeft, uint8_t legRight, uint8_t footLeft, uint8_t footRight, uint8_t pinNoiseSensor, uint8_t pinBuzzer, uint8_t pinUSTrigger, uint8_t pinUSEcho);
         //-- Otto initialization
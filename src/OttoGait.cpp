@@ -0,0 +1,178 @@
+/**
+ * @file OttoGait.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OttoGait.h"
+
+//-- Joint order: left leg, right leg, left foot, right foot, left arm, right arm, head
+//-- Joint fields: {A, Ah, O, Oh, Ph, Pd, src}
+
+//-- Walking (see Otto::walk)
+const OttoGait gait_walk PROGMEM = { GAIT_WALK, {
+    {30, 0,  0, 0,   0,   0, GAIT_P_H},
+    {30, 0,  0, 0,   0,   0, GAIT_P_H},
+    {20, 0,  4, 0,   0, -90, GAIT_P_H},
+    {20, 0, -4, 0,   0, -90, GAIT_P_H},
+    { 0, 2,  0, 0,   0,   0, GAIT_P_ARM},
+    { 0, 2,  0, 0,   0,   0, GAIT_P_ARM},
+    { 0, 2,  0, 0,   0,   0, GAIT_P_HEAD}
+}};
+
+//-- Turning: the hip with the higher amplitude takes the bigger steps
+const OttoGait gait_turn_left PROGMEM = { GAIT_TURN_LEFT, {
+    {30, 0,  0, 0,   0,   0, GAIT_P_H},
+    {10, 0,  0, 0,   0,   0, GAIT_P_H},
+    {20, 0,  4, 0, -90,   0, GAIT_P_H},
+    {20, 0, -4, 0, -90,   0, GAIT_P_H},
+    { 0, 2,  0, 0,   0,   0, GAIT_P_ARM},
+    { 0, 2,  0, 0,   0,   0, GAIT_P_ARM},
+    { 0, 2,  0, 0,   0,   0, GAIT_P_HEAD}
+}};
+
+const OttoGait gait_turn_right PROGMEM = { GAIT_TURN_RIGHT, {
+    {10, 0,  0, 0,   0,   0, GAIT_P_H},
+    {30, 0,  0, 0,   0,   0, GAIT_P_H},
+    {20, 0,  4, 0, -90,   0, GAIT_P_H},
+    {20, 0, -4, 0, -90,   0, GAIT_P_H},
+    { 0, 2,  0, 0,   0,   0, GAIT_P_ARM},
+    { 0, 2,  0, 0,   0,   0, GAIT_P_ARM},
+    { 0, 2,  0, 0,   0,   0, GAIT_P_HEAD}
+}};
+
+//-- Up & down: both feet 180 degrees out of phase
+const OttoGait gait_updown PROGMEM = { GAIT_UPDOWN, {
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 2,  0, 2, -90,   0, GAIT_P_H},
+    { 0, 2,  0,-2,  90,   0, GAIT_P_H},
+    { 0, 2,  0, 2, -90,   0, GAIT_P_H},
+    { 0, 2,  0,-2,  90,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
+
+//-- Swing: both feet in phase, offset is half the amplitude
+const OttoGait gait_swing PROGMEM = { GAIT_SWING, {
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 2,  0, 1,   0,   0, GAIT_P_H},
+    { 0, 2,  0,-1,   0,   0, GAIT_P_H},
+    { 0, 2,  0, 2,   0,   0, GAIT_P_H},
+    { 0, 2,  0,-2,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
+
+//-- Tiptoe swing: the offset is the amplitude to stay on tiptoe
+const OttoGait gait_tiptoe_swing PROGMEM = { GAIT_TIPTOE_SWING, {
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 2,  0, 2,   0,   0, GAIT_P_H},
+    { 0, 2,  0,-2,   0,   0, GAIT_P_H},
+    { 0, 2,  0, 2,   0,   0, GAIT_P_H},
+    { 0, 2,  0,-2,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
+
+//-- Jitter: legs 180 degrees out of phase
+const OttoGait gait_jitter PROGMEM = { GAIT_JITTER, {
+    { 0, 2,  0, 0, -90,   0, GAIT_P_H},
+    { 0, 2,  0, 0,  90,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
+
+//-- Ascending turn: jitter while up & down
+const OttoGait gait_ascending_turn PROGMEM = { GAIT_ASCENDING_TURN, {
+    { 0, 2,  0, 0, -90,   0, GAIT_P_H},
+    { 0, 2,  0, 0,  90,   0, GAIT_P_H},
+    { 0, 2,  4, 2, -90,   0, GAIT_P_H},
+    { 0, 2,  4,-2,  90,   0, GAIT_P_H},
+    {40, 0,  0, 0,   0,   0, GAIT_P_H},
+    {40, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
+
+//-- Moonwalker: travelling wave, feet 60 degrees out of phase
+const OttoGait gait_moonwalker PROGMEM = { GAIT_MOONWALKER, {
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 2,  2, 1,   0, -90, GAIT_P_H},
+    { 0, 2, -2,-1,   0,-150, GAIT_P_H},
+    { 0, 2,  0,-2,   0, -90, GAIT_P_H},
+    { 0, 2,  0, 2,   0, -90, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
+
+//-- Crusaito: mixture between moonwalker and walk
+//-- The legs phase is the 90 rad (117 degrees) of the original gait
+const OttoGait gait_crusaito PROGMEM = { GAIT_CRUSAITO, {
+    {25, 0,  0, 0, 117,   0, GAIT_P_H},
+    {25, 0,  0, 0, 117,   0, GAIT_P_H},
+    { 0, 2,  4, 1,   0,   0, GAIT_P_H},
+    { 0, 2, -4,-1,   0, -60, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
+
+//-- Flapping
+const OttoGait gait_flapping PROGMEM = { GAIT_FLAPPING, {
+    {12, 0,  0, 0,   0,   0, GAIT_P_H},
+    {12, 0,  0, 0, 180,   0, GAIT_P_H},
+    { 0, 2,-10, 2,   0, -90, GAIT_P_H},
+    { 0, 2, 10,-2,   0,  90, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
+
+//-- Hand wave (Otto Lee)
+const OttoGait gait_handwave_left PROGMEM = { GAIT_HANDWAVE_LEFT, {
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    {30, 0,-30, 0,   0,   0, GAIT_P_H},
+    { 0, 0,-40, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
+
+const OttoGait gait_handwave_right PROGMEM = { GAIT_HANDWAVE_RIGHT, {
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0, 40, 0,   0,   0, GAIT_P_H},
+    {30, 0, 60, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
+
+//-- Head No (Otto Lee)
+const OttoGait gait_head_no PROGMEM = { GAIT_HEAD_NO, {
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    { 0, 0,  0, 0,   0,   0, GAIT_P_H},
+    {30, 0,  0, 0,   0,   0, GAIT_P_H}
+}};
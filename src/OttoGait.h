@@ -0,0 +1,106 @@
+/**
+ * @file OttoGait.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Oscillation gait descriptors shared by Otto and Otto Lee
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OTTOGAIT_h
+#define OTTOGAIT_h
+
+#include <Arduino.h>
+#include <stdint.h>
+
+//-- Joints of a gait: Otto uses the first 4, Otto Lee all of them
+#define GAIT_LEG_L          0
+#define GAIT_LEG_R          1
+#define GAIT_FOOT_L         2
+#define GAIT_FOOT_R         3
+#define GAIT_ARM_L          4
+#define GAIT_ARM_R          5
+#define GAIT_HEAD           6
+#define OTTO_GAIT_JOINTS    7
+
+//-- Gait parameter slots
+#define GAIT_P_H            0   //-- Height / amount (h)
+#define GAIT_P_ARM          1   //-- Arm oscillation
+#define GAIT_P_HEAD         2   //-- Head oscillation
+#define GAIT_PARAMS         3
+
+/* Gait List ******************************************************************/
+#define GAIT_CUSTOM             0
+#define GAIT_WALK               1
+#define GAIT_TURN_LEFT          2
+#define GAIT_TURN_RIGHT         3
+#define GAIT_UPDOWN             4
+#define GAIT_SWING              5
+#define GAIT_TIPTOE_SWING       6
+#define GAIT_JITTER             7
+#define GAIT_ASCENDING_TURN     8
+#define GAIT_MOONWALKER         9
+#define GAIT_CRUSAITO           10
+#define GAIT_FLAPPING           11
+#define GAIT_HANDWAVE_LEFT      12
+#define GAIT_HANDWAVE_RIGHT     13
+#define GAIT_HEAD_NO            14
+
+/******************************************************************************/
+
+/**
+ * @brief Oscillator parameters of one joint
+ *
+ * Amplitude = A + (Ah * p) / 2
+ * Offset    = O + (Oh * p) / 2
+ * Phase     = Ph + Pd * dir       (degrees)
+ * with p the gait parameter selected by src
+ */
+typedef struct {
+    int8_t A;       //-- Amplitude (degrees)
+    int8_t Ah;      //-- Amplitude parameter factor (1/2)
+    int8_t O;       //-- Offset (degrees)
+    int8_t Oh;      //-- Offset parameter factor (1/2)
+    int16_t Ph;     //-- Phase (degrees)
+    int16_t Pd;     //-- Phase direction factor (degrees)
+    uint8_t src;    //-- Parameter slot (GAIT_P_xxx)
+} GaitJoint;
+
+/**
+ * @brief Oscillation gait, stored in PROGMEM
+ *
+ */
+typedef struct {
+    uint8_t id;                         //-- GAIT_xxx
+    GaitJoint joint[OTTO_GAIT_JOINTS];
+} OttoGait;
+
+extern const OttoGait gait_walk PROGMEM;
+extern const OttoGait gait_turn_left PROGMEM;
+extern const OttoGait gait_turn_right PROGMEM;
+extern const OttoGait gait_updown PROGMEM;
+extern const OttoGait gait_swing PROGMEM;
+extern const OttoGait gait_tiptoe_swing PROGMEM;
+extern const OttoGait gait_jitter PROGMEM;
+extern const OttoGait gait_ascending_turn PROGMEM;
+extern const OttoGait gait_moonwalker PROGMEM;
+extern const OttoGait gait_crusaito PROGMEM;
+extern const OttoGait gait_flapping PROGMEM;
+extern const OttoGait gait_handwave_left PROGMEM;
+extern const OttoGait gait_handwave_right PROGMEM;
+extern const OttoGait gait_head_no PROGMEM;
+
+#endif //OTTOGAIT_h
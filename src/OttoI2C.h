@@ -0,0 +1,368 @@
+/**
+ * @file OttoI2C.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief I2C peripheral: command and register map to drive Otto from a master
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OTTOI2C_h
+#define OTTOI2C_h
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "OttoGlobal.h"
+#include "OttoGait.h"
+#include "ToneTimer.h"
+
+/** Configuration *************************************************************/
+#define I2C_QUEUE_SIZE          8       //-- Command frames waiting for update() (one place kept free)
+#define I2C_FRAME_SIZE          12      //-- Largest command frame (bytes)
+#define I2C_STATUS_PERIOD       20      //-- Refresh period of the read registers (ms)
+
+//-- Read registers: write the address alone, then read from it
+#define I2C_REG_STATUS          0x00    //-- Status flags (I2C_STATUS_xxx)
+#define I2C_REG_MOTION_FREE     0x01    //-- Free places in the motion queue
+#define I2C_REG_FRAME_FREE      0x02    //-- Free places in the command queue
+#define I2C_REG_LOST            0x03    //-- Frames lost, command queue full (wraps around)
+#define I2C_REG_ERRORS          0x04    //-- Invalid commands (wraps around)
+#define I2C_REG_DISTANCE        0x05    //-- Filtered distance (mm, 2 bytes LSB first)
+#define I2C_REG_CONFIDENCE      0x07    //-- Confidence of the distance (%)
+#define I2C_REG_NOISE           0x08    //-- Noise level (2 bytes LSB first)
+#define I2C_REG_COUNT           0x0A
+
+#define I2C_STATUS_MOVING       0x01
+#define I2C_STATUS_SINGING      0x02
+
+//-- Commands: address followed by the parameters, in one write
+#define I2C_CMD_GAIT            0x20    //-- id, steps, T (2 bytes), h, dir
+#define I2C_CMD_JOINTS          0x21    //-- time (2 bytes), position of each joint (degrees)
+#define I2C_CMD_HOME            0x22    //-- time (2 bytes)
+#define I2C_CMD_STOP            0x23    //-- Stop the motion and drop the queued ones
+#define I2C_CMD_SING            0x24    //-- sound (S_xxx, not the songs), with __USE_TONE_TIMER only
+
+//-- Motions of I2C_CMD_GAIT besides the GAIT_xxx oscillations
+#define I2C_GAIT_JUMP           0x40
+#define I2C_GAIT_BEND           0x41
+#define I2C_GAIT_SHAKE_LEG      0x42
+
+/******************************************************************************/
+
+/**
+ * @brief I2C peripheral driving a robot (Otto or OttoLee)
+ *
+ * The Wire handlers run in the TWI interrupt: onReceive only copies the
+ * frame in a ring buffer and onRequest only copies the read registers,
+ * refreshed by update(). The commands are executed by update() from the
+ * main loop, with the robot in non-blocking mode, so the master is never
+ * held by clock stretching. A motion command waits in the queue while the
+ * motion queue of the robot is full; STOP and SING are executed at once,
+ * and STOP drops the motion commands still waiting.
+ * A sound would hold update() until its end without __USE_TONE_TIMER:
+ * SING is then an invalid command, like the songs (128 and up), which last
+ * tens of seconds.
+ *
+ * @tparam R Robot class
+ */
+template <class R>
+class OttoI2C
+{
+    private:
+        typedef struct {
+            uint8_t length;         //-- 0 = executed, waiting for the frames before it
+            uint8_t data[I2C_FRAME_SIZE];
+        } I2CFrame;
+
+        R *_robot;
+        I2CFrame _queue[I2C_QUEUE_SIZE];
+        volatile uint8_t _head;     //-- Next frame to execute (main loop)
+        volatile uint8_t _tail;     //-- Next free frame (interrupt)
+        volatile uint8_t _lost;
+        volatile uint8_t _pointer;  //-- Read register address
+        uint8_t _errors;
+        uint8_t _registers[I2C_REG_COUNT];
+        uint32_t _statusTime;
+        static OttoI2C<R> *_instance;
+
+        bool _execute(const I2CFrame *frame);
+        bool _gait(const uint8_t *p);
+        void _refresh();
+        static void _onReceive(int count);
+        static void _onRequest();
+
+    public:
+        OttoI2C(R &robot);
+        void begin(uint8_t address);
+        void update();
+        uint8_t getLost() {return _lost;};
+        uint8_t getErrors() {return _errors;};
+};
+
+template <class R>
+OttoI2C<R> *OttoI2C<R>::_instance = NULL;
+
+/**
+ * @brief Construct a new I2C peripheral
+ *
+ * @tparam R Robot class
+ * @param robot Robot driven by the commands
+ */
+template <class R>
+OttoI2C<R>::OttoI2C(R &robot)
+{
+    _robot = &robot;
+    _head = 0;
+    _tail = 0;
+    _lost = 0;
+    _pointer = 0;
+    _errors = 0;
+    memset(_registers, 0, sizeof(_registers));
+}
+
+/**
+ * @brief Join the bus as a peripheral and put the robot in non-blocking mode
+ *
+ * @tparam R Robot class
+ * @param address I2C address
+ */
+template <class R>
+void OttoI2C<R>::begin(uint8_t address)
+{
+    _instance = this;
+    _robot->setBlocking(false);
+    _refresh();
+    Wire.begin(address);
+    Wire.onReceive(_onReceive);
+    Wire.onRequest(_onRequest);
+}
+
+/**
+ * @brief Execute the received commands and refresh the read registers.
+ * Must be called from loop(), with the robot run().
+ *
+ * @tparam R Robot class
+ */
+template <class R>
+void OttoI2C<R>::update()
+{
+    uint8_t tail = _tail;
+    bool blocked = false;
+
+    for (uint8_t i = _head; i != tail; i = (i + 1) % I2C_QUEUE_SIZE) {
+        I2CFrame *frame = &_queue[i];
+        uint8_t command = frame->data[0];
+
+        if (frame->length == 0) continue;   //-- Already executed
+        if ((command == I2C_CMD_GAIT) || (command == I2C_CMD_JOINTS) || (command == I2C_CMD_HOME)) {
+            //-- The motions keep their order behind a blocked one
+            if (blocked || !_execute(frame)) {
+                blocked = true;
+                continue;
+            }
+        }
+        else {
+            //-- The other commands do not wait for the motion queue.
+            //-- STOP drops the motions received before it.
+            if (command == I2C_CMD_STOP) {
+                for (uint8_t j = _head; j != i; j = (j + 1) % I2C_QUEUE_SIZE) _queue[j].length = 0;
+                blocked = false;
+            }
+            _execute(frame);
+        }
+        frame->length = 0;
+    }
+
+    //-- The frames are free once executed, in order
+    while ((_head != tail) && (_queue[_head].length == 0)) {
+        noInterrupts();
+        _head = (_head + 1) % I2C_QUEUE_SIZE;
+        interrupts();
+    }
+
+    if ((millis() - _statusTime) >= I2C_STATUS_PERIOD) _refresh();
+}
+
+/**
+ * @brief Execute a command frame
+ *
+ * @tparam R Robot class
+ * @param frame     Address and parameters
+ * @return true     Done (or invalid), false: to retry when the motion queue has room
+ */
+template <class R>
+bool OttoI2C<R>::_execute(const I2CFrame *frame)
+{
+    const uint8_t *p = &frame->data[1];
+    uint8_t length = frame->length - 1;
+    bool valid = true;
+
+    switch (frame->data[0]) {
+        case I2C_CMD_GAIT:
+            if (length != 6) valid = false;
+            else if (_robot->motionQueueFree() == 0) return false;
+            else valid = _gait(p);
+            break;
+
+        case I2C_CMD_JOINTS:
+            if (length != 2 + _robot->getServoCount()) valid = false;
+            else if (_robot->motionQueueFree() == 0) return false;
+            else {
+                uint8_t target[I2C_FRAME_SIZE];
+                memcpy(target, &p[2], length - 2);
+                _robot->moveServos(p[0] | (p[1] << 8), target);
+            }
+            break;
+
+        case I2C_CMD_HOME:
+            if (length != 2) valid = false;
+            else if (_robot->motionQueueFree() == 0) return false;
+            else _robot->home(p[0] | (p[1] << 8));
+            break;
+
+        case I2C_CMD_STOP:
+            _robot->stopMotion();
+            break;
+
+        case I2C_CMD_SING:
+#ifdef __USE_TONE_TIMER
+            if ((length != 1) || (p[0] >= SongSilentNight)) valid = false;
+            else _robot->sing(p[0]);
+#else
+            valid = false;
+#endif
+            break;
+
+        default:
+            valid = false;
+            break;
+    }
+
+    if (!valid) _errors++;
+    return true;
+}
+
+/**
+ * @brief Start a motion of I2C_CMD_GAIT
+ *
+ * @tparam R Robot class
+ * @param p         id, steps, T (2 bytes), h, dir
+ * @return true     Valid motion
+ */
+template <class R>
+bool OttoI2C<R>::_gait(const uint8_t *p)
+{
+    uint8_t steps = p[1];
+    uint16_t T = p[2] | (p[3] << 8);
+    int16_t h = (int8_t)p[4];
+    int8_t dir = ((int8_t)p[5] < 0) ? -1 : 1;
+
+    if ((steps == 0) || (T == 0)) return false;
+
+    switch (p[0]) {
+        case GAIT_WALK:             _robot->walk(steps, T, dir); break;
+        case GAIT_TURN_LEFT:        _robot->turn(steps, T, LEFT); break;
+        case GAIT_TURN_RIGHT:       _robot->turn(steps, T, RIGHT); break;
+        case GAIT_UPDOWN:           _robot->updown(steps, T, h); break;
+        case GAIT_SWING:            _robot->swing(steps, T, h); break;
+        case GAIT_TIPTOE_SWING:     _robot->tiptoeSwing(steps, T, h); break;
+        case GAIT_JITTER:           _robot->jitter(steps, T, h); break;
+        case GAIT_ASCENDING_TURN:   _robot->ascendingTurn(steps, T, h); break;
+        case GAIT_MOONWALKER:       _robot->moonwalker(steps, T, h, dir); break;
+        case GAIT_CRUSAITO:         _robot->crusaito(steps, T, h, dir); break;
+        case GAIT_FLAPPING:         _robot->flapping(steps, T, h, dir); break;
+        case I2C_GAIT_JUMP:         _robot->jump(steps, T); break;
+        case I2C_GAIT_BEND:         _robot->bend(steps, T, dir); break;
+        case I2C_GAIT_SHAKE_LEG:    _robot->shakeLeg(steps, T, dir); break;
+        default:                    return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Copy the state of the robot in the read registers
+ *
+ * @tparam R Robot class
+ */
+template <class R>
+void OttoI2C<R>::_refresh()
+{
+    uint8_t registers[I2C_REG_COUNT];
+    OttoDistance distance = _robot->getFilteredDistance();
+    uint16_t noise = _robot->getNoise();
+
+    _statusTime = millis();
+    registers[I2C_REG_STATUS] = (_robot->isMoving() ? I2C_STATUS_MOVING : 0) | (_robot->isSinging() ? I2C_STATUS_SINGING : 0);
+    registers[I2C_REG_MOTION_FREE] = _robot->motionQueueFree();
+    registers[I2C_REG_FRAME_FREE] = (I2C_QUEUE_SIZE - 1) - (uint8_t)((_tail - _head + I2C_QUEUE_SIZE) % I2C_QUEUE_SIZE);
+    registers[I2C_REG_LOST] = _lost;
+    registers[I2C_REG_ERRORS] = _errors;
+    registers[I2C_REG_DISTANCE] = distance.mm & 0xFF;
+    registers[I2C_REG_DISTANCE + 1] = distance.mm >> 8;
+    registers[I2C_REG_CONFIDENCE] = distance.confidence;
+    registers[I2C_REG_NOISE] = noise & 0xFF;
+    registers[I2C_REG_NOISE + 1] = noise >> 8;
+
+    //-- A read in the middle gets the old or the new registers, not a mix
+    noInterrupts();
+    memcpy(_registers, registers, I2C_REG_COUNT);
+    interrupts();
+}
+
+/**
+ * @brief Wire receive handler (interrupt): a register address is taken at
+ * once, a command frame is queued for update()
+ *
+ * @tparam R Robot class
+ * @param count Number of bytes received
+ */
+template <class R>
+void OttoI2C<R>::_onReceive(int count)
+{
+    OttoI2C<R> *i2c = _instance;
+    uint8_t next = (i2c->_tail + 1) % I2C_QUEUE_SIZE;
+
+    if (count == 0) return;
+    if ((count == 1) && (Wire.peek() < I2C_REG_COUNT)) i2c->_pointer = Wire.read();
+    else if ((count > I2C_FRAME_SIZE) || (next == i2c->_head)) i2c->_lost++;
+    else {
+        I2CFrame *frame = &i2c->_queue[i2c->_tail];
+        frame->length = count;
+        for (uint8_t i = 0; i < count; i++) frame->data[i] = Wire.read();
+        i2c->_tail = next;
+    }
+
+    //-- Drop what is left of a rejected frame
+    while (Wire.available()) Wire.read();
+}
+
+/**
+ * @brief Wire request handler (interrupt): send the read registers from the
+ * register address
+ *
+ * @tparam R Robot class
+ */
+template <class R>
+void OttoI2C<R>::_onRequest()
+{
+    OttoI2C<R> *i2c = _instance;
+    uint8_t pointer = i2c->_pointer;
+
+    if (pointer >= I2C_REG_COUNT) pointer = 0;
+    Wire.write(&i2c->_registers[pointer], I2C_REG_COUNT - pointer);
+}
+
+#endif //OTTOI2C_h
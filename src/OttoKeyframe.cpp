@@ -0,0 +1,80 @@
+/**
+ * @file OttoKeyframe.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OttoKeyframe.h"
+
+//-- Joint order: left leg, right leg, left foot, right foot, left arm, right arm, head
+//-- Keyframe fields: {{pose}, time, ease}
+
+//-- Jump (see Otto::jump): up and down in T each
+const OttoKeyframe keyframes_jump[2] PROGMEM = {
+    {{90, 90, 150,  30, 110,  70, 90}, KEYFRAME_T(1000), MOVE_DEFAULT},
+    {{90, 90,  90,  90,  90,  90, 90}, KEYFRAME_T(1000), MOVE_DEFAULT}
+};
+
+//-- Lateral bend: fixed 800ms bend to avoid falls, hold 0.8T, back home
+const OttoKeyframe keyframes_bend_left[4] PROGMEM = {
+    {{90, 90,  62,  35, 120,  60, 90}, 400,             MOVE_DEFAULT},
+    {{90, 90,  62, 105,  60, 120, 90}, 400,             MOVE_DEFAULT},
+    {{90, 90,  62, 105,  60, 120, 90}, KEYFRAME_T(800), MOVE_DEFAULT},
+    {{90, 90,  90,  90,  90,  90, 90}, 500,             MOVE_DEFAULT}
+};
+
+//-- Right foot at 120, not 115. Otto is unbalanced
+const OttoKeyframe keyframes_bend_right[4] PROGMEM = {
+    {{90, 90, 145, 120, 120,  60, 90}, 400,             MOVE_DEFAULT},
+    {{90, 90,  75, 120,  60, 120, 90}, 400,             MOVE_DEFAULT},
+    {{90, 90,  75, 120,  60, 120, 90}, KEYFRAME_T(800), MOVE_DEFAULT},
+    {{90, 90,  90,  90,  90,  90, 90}, 500,             MOVE_DEFAULT}
+};
+
+//-- Shake a leg: fixed 2s bend to avoid falls, 2 shakes of T/2, back home
+//-- Right leg (default)
+const OttoKeyframe keyframes_shake_leg_right[7] PROGMEM = {
+    {{90, 90,  58,  35,  90,  90, 90}, 1000,            MOVE_DEFAULT},
+    {{90, 90,  58, 120, 100,  80, 90}, 1000,            MOVE_DEFAULT},
+    {{90, 90,  58,  60,  80, 100, 90}, KEYFRAME_T(250), MOVE_DEFAULT},
+    {{90, 90,  58, 120, 100,  80, 90}, KEYFRAME_T(250), MOVE_DEFAULT},
+    {{90, 90,  58,  60,  80, 100, 90}, KEYFRAME_T(250), MOVE_DEFAULT},
+    {{90, 90,  58, 120, 100,  80, 90}, KEYFRAME_T(250), MOVE_DEFAULT},
+    {{90, 90,  90,  90,  90,  90, 90}, 500,             MOVE_DEFAULT}
+};
+
+//-- Left leg (dir = -1)
+const OttoKeyframe keyframes_shake_leg_left[7] PROGMEM = {
+    {{90, 90, 145, 122,  90,  90, 90}, 1000,            MOVE_DEFAULT},
+    {{90, 90,  60, 122, 100,  80, 90}, 1000,            MOVE_DEFAULT},
+    {{90, 90, 120, 122,  80, 100, 90}, KEYFRAME_T(250), MOVE_DEFAULT},
+    {{90, 90,  60, 122, 100,  80, 90}, KEYFRAME_T(250), MOVE_DEFAULT},
+    {{90, 90, 120, 122,  80, 100, 90}, KEYFRAME_T(250), MOVE_DEFAULT},
+    {{90, 90,  60, 122, 100,  80, 90}, KEYFRAME_T(250), MOVE_DEFAULT},
+    {{90, 90,  90,  90,  90,  90, 90}, 500,             MOVE_DEFAULT}
+};
+
+//-- Rest position held during T
+const OttoKeyframe keyframes_rest_hold[1] PROGMEM = {
+    {{90, 90,  90,  90,  90,  90, 90}, KEYFRAME_T(1000), MOVE_DEFAULT}
+};
+
+//-- Hands up (Otto Lee)
+const OttoKeyframe keyframes_handsup[1] PROGMEM = {
+    {{90, 90,  90,  90,  20, 160, 90}, 500,             MOVE_DEFAULT}
+};
@@ -0,0 +1,64 @@
+/**
+ * @file OttoKeyframe.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Keyframe animations shared by Otto and Otto Lee
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OTTOKEYFRAME_h
+#define OTTOKEYFRAME_h
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "OttoGait.h"
+
+//-- Motion profiles (easing) of moveServos() and of the keyframes
+#define MOVE_LINEAR         0   //-- Constant speed
+#define MOVE_TRAPEZOID      1   //-- Constant acceleration on the first and last quarters
+#define MOVE_MIN_JERK       2   //-- Minimum jerk (5th order polynomial)
+#define MOVE_DEFAULT        0xFF    //-- Keyframes: profile of setMoveProfile()
+
+#define KEYFRAME_KEEP       0xFF                    //-- Pose: the joint keeps its position
+#define KEYFRAME_T_RELATIVE 0x8000                  //-- Time: per-mille of the period T
+#define KEYFRAME_T(pm)      (KEYFRAME_T_RELATIVE | (pm))
+#define KEYFRAME_COUNT(k)   (sizeof(k) / sizeof(OttoKeyframe))
+
+/******************************************************************************/
+
+/**
+ * @brief Keyframe of an animation, stored in PROGMEM
+ *
+ * The joints move from the previous pose to this one in the given time,
+ * with the given motion profile. A keyframe with the same pose as the
+ * previous one holds the position.
+ */
+typedef struct {
+    uint8_t pose[OTTO_GAIT_JOINTS]; //-- Target position (degrees) or KEYFRAME_KEEP
+    uint16_t time;                  //-- Duration (ms) or KEYFRAME_T(per-mille of T)
+    uint8_t ease;                   //-- Motion profile (MOVE_xxx)
+} OttoKeyframe;
+
+extern const OttoKeyframe keyframes_jump[2] PROGMEM;
+extern const OttoKeyframe keyframes_bend_left[4] PROGMEM;
+extern const OttoKeyframe keyframes_bend_right[4] PROGMEM;
+extern const OttoKeyframe keyframes_shake_leg_right[7] PROGMEM;
+extern const OttoKeyframe keyframes_shake_leg_left[7] PROGMEM;
+extern const OttoKeyframe keyframes_rest_hold[1] PROGMEM;
+extern const OttoKeyframe keyframes_handsup[1] PROGMEM;
+
+#endif //OTTOKEYFRAME_h
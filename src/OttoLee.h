@@ -24,9 +24,7 @@
 #define OTTOLEE_h
 
 #include "OttoGlobal.h"
-#include "OttoSound.h"
-#include "OttoSensor.h"
-#include "OttoServo.h"
+#include "OttoRobot.h"
 
 #define _NBR_OF_SERVO   7
 
@@ -36,10 +34,8 @@
  * @brief Otto Lee Driver
  * 
  */
-class OttoLee: public OttoSound, public OttoSensor, public OttoServo<_NBR_OF_SERVO>
+class OttoLee: public OttoRobot<OttoLee, _NBR_OF_SERVO>
 {
-    private:
-        
     public:
         OttoLee(uint8_t legLeft, uint8_t legRight, uint8_t footLeft, uint8_t footRight, uint8_t armLeft, uint8_t armRight, uint8_t head, uint8_t pinNoiseSensor, uint8_t pinBuzzer, uint8_t pinUSTrigger, uint8_t pinUSEcho);
         //-- Otto initialization
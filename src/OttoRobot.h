@@ -0,0 +1,222 @@
+/**
+ * @file OttoRobot.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Common base of the robots: background tasks and guarded walk
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OTTOROBOT_h
+#define OTTOROBOT_h
+
+#include <Arduino.h>
+#include "OttoGlobal.h"
+#include "OttoSound.h"
+#include "OttoSensor.h"
+#include "OttoServo.h"
+#include "OttoScheduler.h"
+
+/**
+ * @brief Sound, sensors and servos of a robot, with the background tasks
+ * of run() and the guarded walk
+ *
+ * The robot class gives its own walk() and turn() (R is the robot class
+ * itself, e.g. class Otto: public OttoRobot<Otto, 4>).
+ *
+ * @tparam R Robot class
+ * @tparam N Number of Servo
+ */
+template <class R, uint8_t N>
+class OttoRobot: public OttoSound, public OttoSensor, public OttoServo<N>
+{
+    private:
+        OttoScheduler _scheduler;
+        static const OttoTask _taskTable[TASK_COUNT];
+        //-- Guarded walk
+        uint16_t _guardDistance;
+        uint8_t _guardAction;
+        uint16_t _guardT;
+        uint8_t _guardCount;    //-- Last ping checked
+        uint8_t _guardNear;     //-- Consecutive pings closer than the distance
+        bool _guardSlowed;
+        void _guardCheck();
+        static void _taskServo(void *robot);
+        static uint16_t _servoDeadline(void *robot);
+        static void _taskGuard(void *robot);
+        static void _taskSound(void *robot);
+        static void _taskRanging(void *robot);
+        static void _taskNoise(void *robot);
+    public:
+        OttoRobot(uint8_t pinBuzzer, uint8_t pinNoiseSensor);
+        //-- Background tasks: servos, sound and sensors
+        bool run();
+        const OttoTaskState &getTaskState(uint8_t task) {return _scheduler.getTaskState(task);};
+        void walkGuarded(float steps, uint16_t T, int8_t dir, uint16_t distance, uint8_t action = GUARD_STOP);
+};
+
+/**
+ * @brief Construct the common part of a robot
+ *
+ * @tparam R Robot class
+ * @tparam N Number of Servo
+ * @param pinBuzzer         Buzzer pin
+ * @param pinNoiseSensor    Noise sensor pin
+ */
+template <class R, uint8_t N>
+OttoRobot<R, N>::OttoRobot(uint8_t pinBuzzer, uint8_t pinNoiseSensor) :
+    OttoSound(pinBuzzer), OttoSensor(pinNoiseSensor), OttoServo<N>(), _scheduler(_taskTable, TASK_COUNT)
+{
+    _guardAction = GUARD_OFF;
+    //-- The songs go on during the blocking motions
+    this->setWaitHook(_taskSound, this);
+}
+
+/** Background tasks **********************************************************/
+
+//-- Task table of run(), the highest priority first
+template <class R, uint8_t N>
+const OttoTask OttoRobot<R, N>::_taskTable[TASK_COUNT] PROGMEM = {
+    {OttoRobot<R, N>::_taskServo,   OttoRobot<R, N>::_servoDeadline, 0,                   TASK_SERVO_BUDGET},
+    {OttoRobot<R, N>::_taskGuard,   NULL,                            TASK_GUARD_PERIOD,   TASK_GUARD_BUDGET},
+    {OttoRobot<R, N>::_taskSound,   NULL,                            TASK_SOUND_PERIOD,   TASK_SOUND_BUDGET},
+    {OttoRobot<R, N>::_taskRanging, NULL,                            TASK_RANGING_PERIOD, TASK_RANGING_BUDGET},
+    {OttoRobot<R, N>::_taskNoise,   NULL,                            NOISE_PERIOD,        TASK_NOISE_BUDGET},
+};
+
+template <class R, uint8_t N>
+void OttoRobot<R, N>::_taskServo(void *robot) {((OttoRobot<R, N> *)robot)->update();}
+template <class R, uint8_t N>
+uint16_t OttoRobot<R, N>::_servoDeadline(void *robot) {return ((OttoRobot<R, N> *)robot)->nextFrame();}
+template <class R, uint8_t N>
+void OttoRobot<R, N>::_taskGuard(void *robot) {((OttoRobot<R, N> *)robot)->_guardCheck();}
+template <class R, uint8_t N>
+void OttoRobot<R, N>::_taskSound(void *robot) {((OttoRobot<R, N> *)robot)->updateSound();}
+template <class R, uint8_t N>
+void OttoRobot<R, N>::_taskRanging(void *robot)
+{
+#ifdef __USE_US_ASYNC
+    ((OttoRobot<R, N> *)robot)->_updateRanging();
+#else
+    //-- The guard sends the pings of a guarded walk: one of the ranging
+    //-- would make it wait a whole period for its own
+    if (((OttoRobot<R, N> *)robot)->_guardAction != GUARD_OFF) return;
+    //-- A short range ping fits between two servo frames
+    ((OttoRobot<R, N> *)robot)->_pingRange(TASK_RANGING_RANGE);
+#endif
+}
+template <class R, uint8_t N>
+void OttoRobot<R, N>::_taskNoise(void *robot) {((OttoRobot<R, N> *)robot)->_updateNoise();}
+
+/**
+ * @brief Run the background tasks, to call from loop() instead of update(),
+ * updateSound() and updateSensors(). The servo frames have the highest
+ * priority: the sound and the sensors only run when their budget fits
+ * before the next frame (see OttoScheduler.h).
+ *
+ * @tparam R Robot class
+ * @tparam N Number of Servo
+ * @return true     Otto is moving or singing
+ */
+template <class R, uint8_t N>
+bool OttoRobot<R, N>::run()
+{
+    _scheduler.run(this);
+    return this->isMoving() || isSinging();
+}
+
+/** Guarded walk **************************************************************/
+
+/**
+ * @brief Walk while watching for obstacles: the distance is measured during
+ * the steps by run() and Otto reacts as soon as a ping is closer than
+ * distance. In blocking mode, returns when Otto stops.
+ *
+ * @tparam R Robot class
+ * @tparam N Number of Servo
+ * @param steps     Number of steps
+ * @param T         Period
+ * @param dir       Direction: FORWARD / BACKWARD
+ * @param distance  Obstacle distance (mm, GUARD_RANGE_MAX at most)
+ * @param action    Reaction: GUARD_STOP / GUARD_SLOW / GUARD_TURN
+ */
+template <class R, uint8_t N>
+void OttoRobot<R, N>::walkGuarded(float steps, uint16_t T, int8_t dir, uint16_t distance, uint8_t action)
+{
+    bool blocking = this->isBlocking();
+
+    this->setBlocking(false);
+    static_cast<R *>(this)->walk(steps, T, dir);
+    this->setBlocking(blocking);
+
+    _guardDistance = (distance < GUARD_RANGE_MAX) ? distance : GUARD_RANGE_MAX;
+    _guardAction = action;
+    _guardT = T;
+    _guardCount = _pingCount;
+    _guardNear = 0;
+    _guardSlowed = false;
+
+    if (blocking) {
+        while (this->isMoving()) run();
+    }
+}
+
+/**
+ * @brief Check the last ping of the guarded walk and react to an obstacle
+ *
+ * @tparam R Robot class
+ * @tparam N Number of Servo
+ */
+template <class R, uint8_t N>
+void OttoRobot<R, N>::_guardCheck()
+{
+    if (_guardAction == GUARD_OFF) return;
+    if (!this->isMoving()) {
+        _guardAction = GUARD_OFF;
+        return;
+    }
+#ifndef __USE_US_ASYNC
+    //-- Own pings within the distance only. No echo says nothing of the
+    //-- farther obstacles: it is kept out of the distance filter
+    _pingRange(_guardDistance, false);
+#endif
+    if (_pingCount == _guardCount) return;
+    _guardCount = _pingCount;
+
+    if (_pingMm > _guardDistance) {
+        _guardNear = 0;
+        return;
+    }
+    if (++_guardNear < GUARD_PINGS) return;
+
+    //-- Called from run(): the reaction must not wait for the motion
+    bool blocking = this->isBlocking();
+    this->setBlocking(false);
+    if ((_guardAction == GUARD_SLOW) && (_pingMm > _guardDistance / 2)) {
+        //-- The period is 16 bits: a slow walk stays at the longest one
+        if (!_guardSlowed) this->setPeriod(min((uint32_t)_guardT * GUARD_SLOW_FACTOR, 0xFFFFUL));
+        _guardSlowed = true;
+    }
+    else {
+        this->stopMotion();
+        if (_guardAction == GUARD_TURN) static_cast<R *>(this)->turn(GUARD_TURN_STEPS, _guardT, GUARD_TURN_DIR);
+        else this->home(GUARD_STOP_TIME);
+        _guardAction = GUARD_OFF;
+    }
+    this->setBlocking(blocking);
+}
+
+#endif //OTTOROBOT_h
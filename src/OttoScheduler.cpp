@@ -0,0 +1,91 @@
+/**
+ * @file OttoScheduler.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Cooperative scheduler of the background tasks
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include "OttoScheduler.h"
+
+/**
+ * @brief Construct a new scheduler
+ *
+ * @param tasks Task table in PROGMEM, the highest priority first
+ * @param count Number of tasks (TASK_COUNT at most)
+ */
+OttoScheduler::OttoScheduler(const OttoTask *tasks, uint8_t count)
+{
+    _tasks = tasks;
+    _count = (count < TASK_COUNT) ? count : TASK_COUNT;
+    resetTaskStates();
+}
+
+/**
+ * @brief Clear the statistics of the tasks and make them all due
+ */
+void OttoScheduler::resetTaskStates()
+{
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < _count; i++) {
+        OttoTaskState *state = &_state[i];
+        state->last = now - 0xFFFF;
+        state->maxTime = 0;
+        state->overruns = 0;
+        state->deferred = 0;
+    }
+}
+
+/**
+ * @brief One pass over the task table. Must be called from the main loop.
+ *
+ * @param robot Object given to the tasks
+ */
+void OttoScheduler::run(void *robot)
+{
+    bool limited = false;
+    uint32_t limit = 0;     //-- Next deadline of a higher priority task (us)
+
+    for (uint8_t i = 0; i < _count; i++) {
+        OttoTask task;
+        OttoTaskState *state = &_state[i];
+        memcpy_P(&task, &_tasks[i], sizeof(OttoTask));
+
+        if ((millis() - state->last) >= task.period) {
+            if (limited && ((int32_t)(limit - micros()) < (int32_t)task.budget)) {
+                if (state->deferred < 0xFFFF) state->deferred++;
+            }
+            else {
+                uint32_t start = micros();
+                state->last = millis();
+                task.run(robot);
+                uint32_t time = micros() - start;
+                if (time > state->maxTime) state->maxTime = (time < 0xFFFF) ? time : 0xFFFF;
+                if ((time > task.budget) && (state->overruns < 0xFFFF)) state->overruns++;
+            }
+        }
+
+        //-- The deadline is known to the ms: the next tick may be right now
+        if (task.deadline) {
+            uint16_t next = task.deadline(robot);
+            uint32_t t = micros() + ((next > 0) ? (uint32_t)(next - 1) * 1000 : 0);
+            if (!limited || ((int32_t)(t - limit) < 0)) limit = t;
+            limited = true;
+        }
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file OttoScheduler.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Cooperative scheduler of the background tasks
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OTTOSCHEDULER_h
+#define OTTOSCHEDULER_h
+
+#include <stdint.h>
+#include "ToneTimer.h"
+#include "US.h"
+#include "OttoGlobal.h"
+
+/** Configuration *************************************************************/
+//-- Tasks of Otto::run() and OttoLee::run(), from the highest priority
+#define TASK_SERVO              0   //-- Oscillator refresh and moves
+#define TASK_GUARD              1   //-- Obstacle check of the guarded walk
+#define TASK_SOUND              2   //-- Tone generation and song streaming
+#define TASK_RANGING            3   //-- Ultrasonic pings and distance filter
+#define TASK_NOISE              4   //-- Noise sampling (without the ADC interrupt)
+#define TASK_COUNT              5
+
+#define TASK_SERVO_BUDGET       1000    //-- Worst case run time of a servo frame (us)
+#define TASK_SOUND_BUDGET       300     //-- Worst case run time of the sound task (us)
+#define TASK_NOISE_BUDGET       200     //-- Worst case run time of a noise sample (us)
+
+#if defined(__USE_TONE_TIMER) && defined(__AVR__)
+  #define TASK_SOUND_PERIOD     10      //-- The interrupt plays the notes: only stream the songs (ms)
+#else
+  #define TASK_SOUND_PERIOD     1
+#endif
+#ifdef __USE_US_ASYNC
+  #define TASK_RANGING_PERIOD   0       //-- The pings are paced by US::update()
+  #define TASK_RANGING_BUDGET   300     //-- Worst case run time of the ranging (us)
+  #define TASK_GUARD_PERIOD     0       //-- Checks each new ping
+  #define TASK_GUARD_BUDGET     300     //-- Worst case run time of an obstacle check (us)
+#else
+  #define TASK_RANGING_PERIOD   US_PING_PERIOD
+  #define TASK_RANGING_RANGE    1000    //-- The ping waits for the echoes within this range (mm)
+  #define TASK_RANGING_BUDGET   (US_ECHO_START + TASK_RANGING_RANGE * 6 + 300)
+  #define TASK_GUARD_PERIOD     US_PING_PERIOD  //-- Sends its own short range pings
+  #define TASK_GUARD_BUDGET     (US_ECHO_START + GUARD_RANGE_MAX * 6 + 300)
+#endif
+
+//-- Guarded walk (see walkGuarded)
+#define GUARD_RANGE_MAX         400     //-- Largest obstacle distance (mm)
+#define GUARD_PINGS             1       //-- Consecutive pings closer than the distance to react
+#define GUARD_STOP_TIME         300     //-- Time to reach the rest position when stopping (ms)
+#define GUARD_SLOW_FACTOR       2       //-- Period multiplier of GUARD_SLOW
+#define GUARD_TURN_STEPS        2       //-- Steps of GUARD_TURN
+#define GUARD_TURN_DIR          LEFT    //-- Direction of GUARD_TURN
+
+//-- Reactions to an obstacle
+#define GUARD_OFF               0
+#define GUARD_STOP              1       //-- Stop and go to the rest position
+#define GUARD_SLOW              2       //-- Slow down, stop at half the distance
+#define GUARD_TURN              3       //-- Turn instead of the remaining steps
+
+/******************************************************************************/
+
+/**
+ * @brief Entry of a task table, read only (PROGMEM)
+ */
+typedef struct {
+    void (*run)(void *robot);           //-- Task body
+    uint16_t (*deadline)(void *robot);  //-- Time before the task must run (ms), NULL: not a hard deadline
+    uint16_t period;                    //-- Time between two runs (ms), 0 = every pass
+    uint16_t budget;                    //-- Worst case run time (us)
+} OttoTask;
+
+/**
+ * @brief Run time statistics of a task
+ */
+typedef struct {
+    uint32_t last;          //-- Time of the last run (ms)
+    uint16_t maxTime;       //-- Longest run (us)
+    uint16_t overruns;      //-- Runs longer than the budget
+    uint16_t deferred;      //-- Runs postponed to keep a higher priority deadline
+} OttoTaskState;
+
+/**
+ * @brief Cooperative scheduler of a fixed task table
+ *
+ * The tasks are listed by priority, the highest first. At each pass, a task
+ * runs when its period has elapsed, unless its budget does not fit in the
+ * time left before the deadline of a higher priority task: it is then
+ * deferred to a later pass. A task without deadline only gives way to the
+ * deadlines of the tasks above it, so the servo frames are never delayed by
+ * the sound or the sensors as long as the budgets are honest.
+ */
+class OttoScheduler
+{
+public:
+    OttoScheduler(const OttoTask *tasks, uint8_t count);
+    void run(void *robot);
+    const OttoTaskState &getTaskState(uint8_t task) {return _state[(task < _count) ? task : 0];};
+    void resetTaskStates();
+
+private:
+    const OttoTask *_tasks;             //-- Task table (PROGMEM)
+    uint8_t _count;
+    OttoTaskState _state[TASK_COUNT];
+};
+
+#endif //OTTOSCHEDULER_h
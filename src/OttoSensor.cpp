@@ -22,6 +22,44 @@
 #include <Arduino.h>
 #include "OttoSensor.h"
 
+#ifdef __USE_NOISE_ADC
+//-- Noise envelopes, updated by the ADC interrupt (one noise sensor)
+static volatile uint16_t _noiseRing[NOISE_RING_SIZE];  //-- Last samples (0 - 1023)
+static volatile uint8_t _noiseHead;
+static volatile uint16_t _noiseSum;                     //-- Sum of the ring
+static volatile uint16_t _noisePeak;                    //-- Peak deviation from the average (x16)
+static volatile uint32_t _noiseSquare;                  //-- Mean square deviation
+
+/**
+ * @brief Add a sample to the envelopes: moving average over the ring,
+ * decaying peak and mean square of the deviation from the average
+ * 
+ * @param sample ADC value (0 - 1023)
+ */
+static void _addNoiseSample(uint16_t sample)
+{
+    _noiseSum += sample - _noiseRing[_noiseHead];
+    _noiseRing[_noiseHead] = sample;
+    _noiseHead = (_noiseHead + 1) & (NOISE_RING_SIZE - 1);
+
+    int16_t deviation = (int16_t)sample - (int16_t)(_noiseSum / NOISE_RING_SIZE);
+    uint16_t level = (deviation < 0) ? -deviation : deviation;
+
+    uint16_t peak = _noisePeak - (_noisePeak >> NOISE_PEAK_DECAY);
+    _noisePeak = ((level << 4) > peak) ? (level << 4) : peak;
+
+    uint32_t square = (uint32_t)level * level;
+    _noiseSquare = _noiseSquare + ((int32_t)(square - _noiseSquare) >> NOISE_RMS_SHIFT);
+}
+
+#if defined(__AVR__)
+ISR(ADC_vect)
+{
+    _addNoiseSample(ADC);
+}
+#endif
+#endif //__USE_NOISE_ADC
+
 OttoSensor::OttoSensor(uint8_t pinNoiseSensor)
 {
     _pinNoiseSensor = pinNoiseSensor;
@@ -40,8 +78,43 @@ void OttoSensor::init(uint8_t USTrigger, uint8_t USEcho)
 {
     //US sensor init with the pins:
     _us.init(USTrigger, USEcho);
+    _usCount = _us.getCount();
+    _pingCount = 0;
+    _pingMm = DISTANCE_NONE;
+    _filter = DISTANCE_FILTER_MEDIAN;
+    _ringHead = 0;
+    _ringCount = 0;
+    _distance = DISTANCE_NONE;
+    _confidence = 0;
+    _distanceTime = millis();
+#ifndef __USE_US_ASYNC
+    _pingTime = millis() - US_PING_PERIOD;
+#endif
 
     randomSeed(analogRead(_pinNoiseSensor));
+
+#ifdef __USE_NOISE_ADC
+    //-- Start from the current level
+    uint16_t sample = analogRead(_pinNoiseSensor);
+    for (uint8_t i = 0; i < NOISE_RING_SIZE; i++) _noiseRing[i] = sample;
+    _noiseSum = sample * NOISE_RING_SIZE;
+    _noiseHead = 0;
+    _noisePeak = 0;
+    _noiseSquare = 0;
+#if defined(__AVR__)
+    //-- ADC triggered by the Timer0 overflow, AVcc reference
+    uint8_t channel = (_pinNoiseSensor >= A0) ? _pinNoiseSensor - A0 : _pinNoiseSensor;
+    ADMUX = _BV(REFS0) | (channel & 0x07);
+    ADCSRB = (ADCSRB & ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0))) | _BV(ADTS2);
+#if defined(MUX5)
+    //-- Channels 8 to 15 of the Mega (A8-A15) are selected by MUX5
+    ADCSRB = (ADCSRB & ~_BV(MUX5)) | (((channel >> 3) & 0x01) << MUX5);
+#endif
+    ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+#else
+    _noiseTime = millis();
+#endif
+#endif
 }
 
 /**
@@ -51,6 +124,13 @@ void OttoSensor::init(uint8_t USTrigger, uint8_t USEcho)
  */
 uint16_t OttoSensor::getNoise()
 {
+#ifdef __USE_NOISE_ADC
+    //-- Average of the last samples
+    noInterrupts();
+    uint16_t sum = _noiseSum;
+    interrupts();
+    return sum / NOISE_RING_SIZE;
+#else
     uint16_t noiseLevel = 0;
     uint16_t noiseReadings = 0;
 
@@ -64,7 +144,44 @@ uint16_t OttoSensor::getNoise()
     noiseLevel = noiseReadings / 2;
 
     return noiseLevel;
+#endif
+}
+
+#ifdef __USE_NOISE_ADC
+/**
+ * @brief Peak of the noise: deviation from the average, decaying
+ * (claps, knocks...)
+ * 
+ * @return uint16_t Peak level (0 - 1023)
+ */
+uint16_t OttoSensor::getNoisePeak()
+{
+    noInterrupts();
+    uint16_t peak = _noisePeak;
+    interrupts();
+    return peak >> 4;
+}
+
+/**
+ * @brief RMS level of the noise (deviation from the average)
+ * 
+ * @return uint16_t RMS level (0 - 1023)
+ */
+uint16_t OttoSensor::getNoiseRMS()
+{
+    noInterrupts();
+    uint32_t square = _noiseSquare;
+    interrupts();
+
+    //-- Integer square root, 16 iterations
+    uint16_t root = 0;
+    for (uint16_t bit = 0x8000; bit > 0; bit >>= 1) {
+        uint16_t trial = root | bit;
+        if ((uint32_t)trial * trial <= square) root = trial;
+    }
+    return root;
 }
+#endif
 
 /**
  * @brief return Otto's ultrasonic sensor measure
@@ -75,3 +192,178 @@ float OttoSensor::getDistance()
 {
     return _us.read();
 }
+
+/**
+ * @brief Background sensing, to call periodically from loop().
+ * A ping is sent every US_PING_PERIOD and added to the filtered distance.
+ * Without __USE_US_ASYNC (see US.h) the ping waits for the echo.
+ * With __USE_NOISE_ADC, the noise is sampled here when there is no ADC
+ * interrupt (not AVR).
+ * 
+ * @return true     A new distance is available
+ */
+bool OttoSensor::updateSensors()
+{
+    _updateNoise();
+    return _updateRanging();
+}
+
+/**
+ * @brief Take a noise sample when the ADC interrupt does not
+ * (and keep the level for the telemetry)
+ */
+void OttoSensor::_updateNoise()
+{
+#if defined(__USE_NOISE_ADC) && !defined(__AVR__)
+    //-- No ADC interrupt: sample from here
+    if ((millis() - _noiseTime) >= NOISE_PERIOD) {
+        _noiseTime = millis();
+        _addNoiseSample(analogRead(_pinNoiseSensor));
+    }
+#endif
+#if defined(__USE_TELEMETRY) && defined(__USE_NOISE_ADC)
+    OttoTelemetry::logNoise(getNoise());
+#endif
+}
+
+/**
+ * @brief Send a ping when it is time and filter the new measure
+ * 
+ * @return true     A new measure was added to the filter
+ */
+bool OttoSensor::_updateRanging()
+{
+#ifdef __USE_US_ASYNC
+    _us.update();
+#else
+    if ((millis() - _pingTime) >= US_PING_PERIOD) {
+        _pingTime = millis();
+        _us.read();
+    }
+#endif
+    return _updateDistance();
+}
+
+#ifndef __USE_US_ASYNC
+/**
+ * @brief Send a ping that only waits for the echoes of the obstacles closer
+ * than mm, when it is time. Takes US_ECHO_START + 5.8us per mm at most.
+ * 
+ * @param mm        Range of the ping (mm)
+ * @param none      false: a ping without echo is left out of the filter
+ *                  (nothing within mm says nothing of the farther obstacles)
+ * @return true     A new measure was added to the filter
+ */
+bool OttoSensor::_pingRange(uint16_t mm, bool none)
+{
+    if ((millis() - _pingTime) >= US_PING_PERIOD) {
+        _pingTime = millis();
+        _us.read(US_ECHO_START + ((uint32_t)mm * 58 + 9) / 10);
+    }
+    return _updateDistance(none);
+}
+#endif
+
+/**
+ * @brief Select the filter of the distance
+ * 
+ * @param filter DISTANCE_FILTER_MEDIAN / DISTANCE_FILTER_EMA / DISTANCE_FILTER_NONE
+ */
+void OttoSensor::setDistanceFilter(uint8_t filter)
+{
+    _filter = filter;
+    _ringHead = 0;
+    _ringCount = 0;
+    _distance = DISTANCE_NONE;
+    _confidence = 0;
+}
+
+/**
+ * @brief Filtered distance of the recent pings (see updateSensors).
+ * The filter runs once per ping: reading the value costs nothing.
+ * 
+ * @return OttoDistance Distance, confidence and age
+ */
+OttoDistance OttoSensor::getFilteredDistance()
+{
+    OttoDistance distance;
+
+    _updateDistance();
+    distance.mm = _distance;
+    distance.confidence = _confidence;
+    distance.age = millis() - _distanceTime;
+    return distance;
+}
+
+/**
+ * @brief Add the last ultrasonic measure to the filter, if it is new
+ * 
+ * @param none      false: a ping without echo only updates the last ping
+ * @return true     A new measure was added
+ */
+bool OttoSensor::_updateDistance(bool none)
+{
+    uint8_t count = _us.getCount();
+    if (count == _usCount) return false;
+    _usCount = count;
+    _distanceTime = millis();
+
+    //-- 5.8us per mm (round trip at 343m/s)
+    uint16_t echo = _us.getEcho();
+    uint16_t mm = (echo == 0) ? DISTANCE_NONE : (uint16_t)(((uint32_t)echo * 10 + 29) / 58);
+    _pingMm = mm;
+    _pingCount++;
+#ifdef __USE_TELEMETRY
+    OttoTelemetry::logDistance(mm);
+#endif
+    if ((mm == DISTANCE_NONE) && !none) return false;
+
+    _ring[_ringHead] = mm;
+    _ringHead = (_ringHead + 1) % DISTANCE_RING_SIZE;
+    if (_ringCount < DISTANCE_RING_SIZE) _ringCount++;
+
+    //-- Pings with an echo, sorted
+    uint16_t sorted[DISTANCE_RING_SIZE];
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < _ringCount; i++) {
+        uint16_t v = _ring[i];
+        if (v == DISTANCE_NONE) continue;
+        uint8_t j = n++;
+        while ((j > 0) && (sorted[j - 1] > v)) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+
+    //-- Nothing in range if most of the recent pings have no echo
+    if (2 * n <= _ringCount) {
+        _distance = DISTANCE_NONE;
+        _confidence = (uint16_t)(_ringCount - n) * 100 / _ringCount;
+        return true;
+    }
+
+    switch (_filter) {
+        case DISTANCE_FILTER_EMA:
+            if (mm == DISTANCE_NONE) break;
+            if (_distance == DISTANCE_NONE) _ema = (uint32_t)mm << 4;
+            else _ema = _ema + ((((int32_t)mm << 4) - (int32_t)_ema) >> DISTANCE_EMA_SHIFT);
+            _distance = (_ema + 8) >> 4;
+            break;
+        case DISTANCE_FILTER_NONE:
+            if (mm != DISTANCE_NONE) _distance = mm;
+            break;
+        default:
+            _distance = sorted[n / 2];
+            break;
+    }
+
+    //-- Confidence: part of the recent pings close to the value
+    uint8_t agree = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        if (abs((int32_t)sorted[i] - _distance) <= DISTANCE_AGREE) agree++;
+    }
+    _confidence = (uint16_t)agree * 100 / _ringCount;
+
+    return true;
+}
@@ -25,18 +25,82 @@
 
 #include <stdint.h>
 #include <US.h>
+#include "OttoTelemetry.h"
+
+/** Configuration *************************************************************/
+//-- Uncomment to sample the noise sensor in the background: on AVR the ADC is
+//-- triggered by the Timer0 overflow (976Hz) and analogRead() cannot be used
+//-- on other pins; elsewhere updateSensors() samples every NOISE_PERIOD.
+// #define __USE_NOISE_ADC     1
+
+#define NOISE_RING_SIZE         32  //-- Samples of the average (power of 2)
+#define NOISE_PEAK_DECAY        6   //-- Peak decay per sample: 1 / 2^decay
+#define NOISE_RMS_SHIFT         5   //-- RMS averaging: 1 / 2^shift per sample
+#define NOISE_PERIOD            1   //-- Software sampling period (ms)
+
+#define DISTANCE_FILTER_MEDIAN  0   //-- Median of the last pings
+#define DISTANCE_FILTER_EMA     1   //-- Exponential moving average
+#define DISTANCE_FILTER_NONE    2   //-- Last ping
+
+#define DISTANCE_RING_SIZE      5   //-- Number of pings kept for the filter
+#define DISTANCE_EMA_SHIFT      2   //-- EMA weight of a new ping: 1 / 2^shift
+#define DISTANCE_AGREE          30  //-- A ping agrees with the filtered value within this (mm)
+#define DISTANCE_NONE           0xFFFF  //-- No echo in the recent pings
+
+/******************************************************************************/
+
+/**
+ * @brief Filtered distance
+ */
+typedef struct {
+    uint16_t mm;            //-- Distance (mm), DISTANCE_NONE if nothing in range
+    uint8_t confidence;     //-- Part of the recent pings agreeing with the value (%)
+    uint32_t age;           //-- Time since the last ping (ms)
+} OttoDistance;
 
 class OttoSensor
 {
 private:
     uint8_t _pinNoiseSensor;
     US _us;
+    //-- Filtered distance
+    uint16_t _ring[DISTANCE_RING_SIZE];  //-- Recent pings (mm), DISTANCE_NONE = no echo
+    uint8_t _ringHead;
+    uint8_t _ringCount;
+    uint8_t _filter;
+    uint8_t _usCount;                    //-- Last US measure added to the ring
+    uint16_t _distance;                  //-- Filtered value (mm)
+    uint32_t _ema;                       //-- EMA state (mm << 4)
+    uint8_t _confidence;
+    uint32_t _distanceTime;              //-- Time of the last ping (ms)
+#ifndef __USE_US_ASYNC
+    uint32_t _pingTime;
+#endif
+#if defined(__USE_NOISE_ADC) && !defined(__AVR__)
+    uint32_t _noiseTime;
+#endif
+    bool _updateDistance(bool none = true);
+protected:
+    uint8_t _pingCount;                  //-- Pings added to the filter (wraps around)
+    uint16_t _pingMm;                    //-- Last ping (mm), DISTANCE_NONE = no echo
+    void _updateNoise();
+    bool _updateRanging();
+#ifndef __USE_US_ASYNC
+    bool _pingRange(uint16_t mm, bool none = true);
+#endif
 public:
     OttoSensor(uint8_t pinNoiseSensor);
     ~OttoSensor();
     void init(uint8_t USTrigger, uint8_t USEcho);
     uint16_t getNoise();      //Noise Sensor
+#ifdef __USE_NOISE_ADC
+    uint16_t getNoisePeak();
+    uint16_t getNoiseRMS();
+#endif
     float getDistance(); //US sensor
+    bool updateSensors();
+    void setDistanceFilter(uint8_t filter);
+    OttoDistance getFilteredDistance();
 };
 
 
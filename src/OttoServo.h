@@ -27,6 +27,21 @@
 #include <EEPROM.h>
 #include <stdint.h>
 #include "Oscillator.h"
+#include "OttoGait.h"
+#include "OttoKeyframe.h"
+#include "OttoTelemetry.h"
+
+/** Motion engine *************************************************************/
+#define MOTION_IDLE         0
+#define MOTION_OSCILLATE    1
+#define MOTION_MOVE         2
+#define MOTION_KEYFRAMES    3
+
+#define MOTION_FRAME_TIME   10  //-- moveServos() interpolation period (ms)
+#define MOTION_QUEUE_SIZE   4   //-- Number of motions waiting to be executed
+
+typedef void (*OttoMotionCallback)(void);
+typedef void (*OttoWaitHook)(void *context);
 
 /**
  * @brief Otto Servo Driver
@@ -44,16 +59,87 @@ class OttoServo
         uint8_t _servo_position[N];
         bool _isOttoResting;
 
-        uint32_t _final_time;
-        uint32_t _partial_time;
-        float _increment[N];
+        //-- Motion command
+        typedef struct {
+            uint8_t type;           //-- MOTION_OSCILLATE / MOTION_MOVE / MOTION_KEYFRAMES
+            bool home;              //-- Detach the servos at the end (rest position)
+            uint8_t profile;        //-- Move profile (MOVE_xxx)
+            uint16_t T;             //-- Oscillation period (ms)
+            uint32_t duration;      //-- Duration of the motion (ms)
+            int16_t A[N];           //-- Oscillation amplitude (degrees)
+            int16_t O[N];           //-- Oscillation offset or move target (degrees)
+            uint16_t phase[N];      //-- Oscillation phase (65536 = 1 turn)
+            const OttoKeyframe *frames; //-- Keyframes (PROGMEM)
+            uint8_t count;          //-- Number of keyframes
+            uint16_t repeat;        //-- Number of plays of the keyframes
+#ifdef __USE_TELEMETRY
+            uint8_t gait;           //-- Gait of the oscillation (GAIT_xxx)
+#endif
+        } MotionCommand;
+
+        //-- Motion engine state
+        uint8_t _motionType;
+        uint8_t _prevMotionType;
+        uint16_t _motionT;
+        uint16_t _blendTime;
+        bool _blocking;
+        bool _detachOnDone;
+        uint32_t _motionStart;
+        uint32_t _motionDuration;
+        uint32_t _motionEnd;
+        uint32_t _lastFrame;
+        uint32_t _moveStart;        //-- Start of the current move / keyframe
+        uint32_t _moveDuration;
+        uint32_t _moveRate;         //-- 2^32 / duration of the move
+        uint8_t _moveProfile;       //-- Profile of the current move
+        uint8_t _defaultProfile;    //-- Profile used by moveServos()
+        uint8_t _servo_start[N];
+        uint8_t _servo_target[N];
+        OttoMotionCallback _motionCallback;
+        OttoWaitHook _waitHook;     //-- Called on each frame of a blocking wait
+        void *_waitContext;
+        bool _streaming;            //-- Frames output by writeServos() on a clock
+        uint32_t _streamFrame;      //-- Time of the next streamed frame (ms)
+#ifdef __USE_OSC_STATS
+        OscStats _sampleStats;
+#endif
+#ifdef __USE_TELEMETRY
+        uint8_t _gait;              //-- Gait of the current oscillation
+#endif
+
+        //-- Keyframe player state
+        const OttoKeyframe *_kfFrames;
+        uint8_t _kfCount;
+        uint8_t _kfIndex;
+        uint16_t _kfRepeat;
+        uint16_t _kfT;
+
+        //-- Motion queue (ring buffer)
+        MotionCommand _queue[MOTION_QUEUE_SIZE];
+        uint8_t _queueHead;
+        uint8_t _queueCount;
+
+        MotionCommand *_newMotion(uint8_t type, uint32_t duration);
+        void _queueMotion();
+        void _startMotion(uint32_t t0);
+        void _endMotion();
+        void _waitMotion();
+        bool _waitFrame();
+        void _commitFrame();
+        void _startMove(uint32_t t0, uint32_t duration, uint8_t profile);
+        void _nextKeyframe(uint32_t t0);
+        static uint32_t _keyframeTime(const OttoKeyframe *frame, uint16_t T);
+        static uint32_t _profile(uint8_t profile, uint32_t u);
 
     protected:
         //-- Predetermined Motion Functions
         void execute(int16_t A[N], int16_t O[N], uint16_t T, double phase_diff[N], float steps);
+        void executeGait(const OttoGait *gait, float steps, uint16_t T, int16_t h = 0, int8_t dir = 1, int16_t arm = 0, int16_t head = 0);
         //-- Attach & detach functions
         void attachServos();
         void detachServos();
+        //-- Background work of the blocking waits (e.g. the sound)
+        void setWaitHook(OttoWaitHook hook, void *context) {_waitHook = hook; _waitContext = context;};
     public:
         OttoServo();
         void init(uint8_t *servoPin);
@@ -65,9 +151,30 @@ class OttoServo
         //-- Predetermined Motion Functions
         void moveSingle(uint8_t position, uint8_t servo_number);
         void moveServos(uint32_t time, uint8_t  servo_target[]);
+        void writeServos(const uint8_t position[N]);
+        void setStreamFrame(bool streaming, uint32_t time = 0) {_streaming = streaming; _streamFrame = time;};
         void oscillateServos(int16_t A[N], int16_t O[N], uint16_t T, double phase_diff[N], float cycle=1);
+        void playKeyframes(const OttoKeyframe *frames, uint8_t count, uint16_t T = 1000, uint16_t repeat = 1);
         //-- HOME = Otto at rest position
         void home(uint32_t time = 500);
+        //-- Motion engine
+        bool update();
+        bool isMoving() {return _motionType != MOTION_IDLE;};
+        uint8_t getServoCount() {return N;};
+        uint16_t nextFrame();
+        uint8_t motionQueueFree() {return MOTION_QUEUE_SIZE - _queueCount;};
+        void stopMotion();
+        void setBlocking(bool blocking) {_blocking = blocking;};
+        bool isBlocking() {return _blocking;};
+        void setMotionCallback(OttoMotionCallback callback) {_motionCallback = callback;};
+        void setBlendTime(uint16_t time) {_blendTime = time;};
+        void setPeriod(uint16_t T);
+        void setMoveProfile(uint8_t profile) {if (profile != MOVE_DEFAULT) _defaultProfile = profile;};
+#ifdef __USE_OSC_STATS
+        //-- Sampling statistics of the oscillations (see OscStats)
+        OscStats &getSampleStats() {return _sampleStats;};
+        void resetSampleStats() {_sampleStats.reset();};
+#endif
 };
 
 
@@ -79,6 +186,19 @@ class OttoServo
 template <uint8_t N>
 OttoServo<N>::OttoServo()
 {
+    _motionType = MOTION_IDLE;
+    _prevMotionType = MOTION_IDLE;
+    _blendTime = 0;
+    _defaultProfile = MOVE_LINEAR;
+    _blocking = true;
+    _isOttoResting = true;
+    _detachOnDone = false;
+    _motionCallback = NULL;
+    _waitHook = NULL;
+    _streaming = false;
+    _motionEnd = 0;
+    _queueHead = 0;
+    _queueCount = 0;
 }
 
 /**
@@ -195,34 +315,22 @@ int8_t OttoServo<N>::loadTrimsFromEEPROM(uint8_t servoNumber)
 /** Basic motion functions ****************************************************/
 
 /**
- * @brief 
+ * @brief Move all Servo to a target position in a given time
+ * 
+ * In blocking mode (default) the function returns once the target is reached,
+ * otherwise the motion is queued and driven by update().
  * 
  * @tparam N Number of Servo
- * @param time 
- * @param servo_target 
+ * @param time          Duration of the motion (ms)
+ * @param servo_target  Target position Array (degrees)
  */
 template <uint8_t N>
 void OttoServo<N>::moveServos(uint32_t time, uint8_t  servo_target[]) 
 {
-    attachServos();
-    if(_isOttoResting == true){
-        _isOttoResting = false;
-    }
-
-    if(time>10){
-        for (int i = 0; i < N; i++) _increment[i] = ((servo_target[i]) - _servo_position[i]) / (time / 10.0);
-        _final_time =  millis() + time;
+    MotionCommand *cmd = _newMotion(MOTION_MOVE, time);
 
-        for (int iteration = 1; millis() < _final_time; iteration++) {
-        _partial_time = millis() + 10;
-        for (int i = 0; i < N; i++) _servo[i].SetPosition(_servo_position[i] + (iteration * _increment[i]));
-        while (millis() < _partial_time); //pause
-        }
-    }
-    else{
-        for (int i = 0; i < N; i++) _servo[i].SetPosition(servo_target[i]);
-    }
-    for (int i = 0; i < N; i++) _servo_position[i] = servo_target[i];
+    for (uint8_t i=0; i<N; i++) cmd->O[i] = servo_target[i];
+    _queueMotion();
 }
 
 /**
@@ -236,68 +344,138 @@ template <uint8_t N>
 void OttoServo<N>::moveSingle(uint8_t position, uint8_t servo_number) 
 {
     if (position > 180) position = 90;
-    if (position < 0) position = 90;
-    attachServos();
-    if(_isOttoResting == true) _isOttoResting = false;
     if(servo_number >= N) return;
+    //-- The servos are only detached at rest
+    if(_isOttoResting == true) {
+        attachServos();
+        _isOttoResting = false;
+    }
     _servo[servo_number].SetPosition(position);
+    _servo_position[servo_number] = position;
+    _commitFrame();
 }
 
 /**
- * @brief 
+ * @brief Output the positions of all the Servo at once, without motion.
+ * Used to stream positions computed elsewhere, one call per frame.
+ * 
+ * @tparam N Number of Servo
+ * @param position Position Array (degrees)
+ */
+template <uint8_t N>
+void OttoServo<N>::writeServos(const uint8_t position[N])
+{
+    if(_isOttoResting == true) {
+        attachServos();
+        _isOttoResting = false;
+    }
+    for (uint8_t i=0; i<N; i++) {
+        _servo_position[i] = (position[i] > 180) ? 90 : position[i];
+        _servo[i].SetPosition(_servo_position[i]);
+    }
+    _commitFrame();
+}
+
+/**
+ * @brief Oscillate all Servo during a number of cycles
  * 
  * @tparam N 
- * @param A 
- * @param O 
- * @param T 
- * @param phase_diff 
- * @param cycle 
+ * @param A             Amplitude Array (degrees)
+ * @param O             Offset Array (degrees)
+ * @param T             Period (ms)
+ * @param phase_diff    Phase Array (radians)
+ * @param cycle         Number of cycles
  */
 template <uint8_t N>
 void OttoServo<N>::oscillateServos(int16_t A[N], int16_t O[N], uint16_t T, double phase_diff[N], float cycle)
 {
+    MotionCommand *cmd = _newMotion(MOTION_OSCILLATE, (uint32_t)(T * cycle));
 
-  for (int i=0; i<N; i++) {
-    _servo[i].SetO(O[i]);
-    _servo[i].SetA(A[i]);
-    _servo[i].SetT(T);
-    _servo[i].SetPh(phase_diff[i]);
-  }
-  double ref=millis();
-   for (double x=ref; x<=T*cycle+ref; x=millis()) {
-     for (int i=0; i<N; i++){
-        _servo[i].refresh();
-     }
-  }
+    cmd->T = T;
+    for (uint8_t i=0; i<N; i++) {
+        cmd->A[i] = A[i];
+        cmd->O[i] = O[i];
+        cmd->phase[i] = RAD2PHASE(phase_diff[i]);
+    }
+    _queueMotion();
 }
 
 /**
- * @brief 
+ * @brief Play a keyframe animation stored in PROGMEM
  * 
  * @tparam N 
- * @param A 
- * @param O 
- * @param T 
- * @param phase_diff 
- * @param steps 
+ * @param frames    Keyframes (PROGMEM)
+ * @param count     Number of keyframes
+ * @param T         Period, for the keyframe times relative to T (ms)
+ * @param repeat    Number of plays
+ */
+template <uint8_t N>
+void OttoServo<N>::playKeyframes(const OttoKeyframe *frames, uint8_t count, uint16_t T, uint16_t repeat)
+{
+    if ((count == 0) || (repeat == 0)) return;
+
+    uint32_t duration = 0;
+    for (uint8_t i=0; i<count; i++) duration += _keyframeTime(&frames[i], T);
+
+    MotionCommand *cmd = _newMotion(MOTION_KEYFRAMES, duration * repeat);
+    cmd->T = T;
+    cmd->frames = frames;
+    cmd->count = count;
+    cmd->repeat = repeat;
+    _queueMotion();
+}
+
+/**
+ * @brief Oscillate all Servo during a number of steps (one step = one period)
+ * 
+ * @tparam N 
+ * @param A             Amplitude Array (degrees)
+ * @param O             Offset Array (degrees)
+ * @param T             Period (ms)
+ * @param phase_diff    Phase Array (radians)
+ * @param steps         Number of steps
  */
 template <uint8_t N>
 void OttoServo<N>::execute(int16_t A[N], int16_t O[N], uint16_t T, double phase_diff[N], float steps)
 {
-    attachServos();
-    if(_isOttoResting == true) _isOttoResting = false;
+    oscillateServos(A, O, T, phase_diff, steps);
+}
 
-    int cycles=(int)steps;    
+/**
+ * @brief Oscillate all Servo with a gait descriptor stored in PROGMEM
+ * 
+ * @tparam N 
+ * @param gait      Gait descriptor (PROGMEM)
+ * @param steps     Number of steps
+ * @param T         Period (ms)
+ * @param h         Height / amount parameter of the gait
+ * @param dir       Direction parameter of the gait (1 / -1)
+ * @param arm       Arm oscillation parameter of the gait
+ * @param head      Head oscillation parameter of the gait
+ */
+template <uint8_t N>
+void OttoServo<N>::executeGait(const OttoGait *gait, float steps, uint16_t T, int16_t h, int8_t dir, int16_t arm, int16_t head)
+{
+    MotionCommand *cmd = _newMotion(MOTION_OSCILLATE, (uint32_t)(T * steps));
+    int16_t param[GAIT_PARAMS] = {h, arm, head};
+    GaitJoint joint;
 
-    //-- Execute complete cycles
-    if (cycles >= 1) {
-        for(int i = 0; i < cycles; i++) {
-            oscillateServos(A,O, T, phase_diff);
+    cmd->T = T;
+    for (uint8_t i=0; i<N; i++) {
+        if (i >= OTTO_GAIT_JOINTS) {
+            cmd->A[i] = 0; cmd->O[i] = 0; cmd->phase[i] = 0;
+            continue;
         }
+        memcpy_P(&joint, &gait->joint[i], sizeof(GaitJoint));
+        int16_t p = param[joint.src];
+        cmd->A[i] = joint.A + (joint.Ah * p) / 2;
+        cmd->O[i] = joint.O + (joint.Oh * p) / 2;
+        cmd->phase[i] = DEG2PHASE(joint.Ph + joint.Pd * dir);
     }
-        
-    //-- Execute the final not complete cycle    
-    oscillateServos(A,O, T, phase_diff,(float)steps-cycles);
+#ifdef __USE_TELEMETRY
+    cmd->gait = pgm_read_byte(&gait->id);
+#endif
+    _queueMotion();
 }
 
 /** Home position *************************************************************/
@@ -311,15 +489,433 @@ void OttoServo<N>::execute(int16_t A[N], int16_t O[N], uint16_t T, double phase_
 template <uint8_t N>
 void OttoServo<N>::home(uint32_t time)
 {
-    uint8_t homes[N];
-
     if(_isOttoResting == false) { //Go to rest position only if necessary
-        for(uint8_t i=0; i<N; i++) homes[i] = 90; //All the servos at rest position
-        moveServos(time,homes); 
+        MotionCommand *cmd = _newMotion(MOTION_MOVE, time);
+        for(uint8_t i=0; i<N; i++) cmd->O[i] = 90; //All the servos at rest position
+        cmd->home = true;   //-- Servos are detached once the rest position is reached
+        _queueMotion();
+    }
+}
+
+/** Motion engine *************************************************************/
+
+/**
+ * @brief Advance the current motion. Must be called periodically from loop()
+ * when the blocking mode is disabled.
+ * 
+ * @tparam N Number of Servo
+ * @return true     A motion is in progress
+ * @return false    Otto is idle
+ */
+template <uint8_t N>
+bool OttoServo<N>::update()
+{
+    uint32_t now = millis();
+    uint32_t elapsed = now - _motionStart;
+    bool newFrame = false;
+
+    switch(_motionType) {
+        case MOTION_OSCILLATE:
+            for (uint8_t i=0; i<N; i++) {
+                if (_servo[i].refresh()) {
+#ifdef __USE_OSC_STATS
+                    //-- All the joints are on the same grid: one record per frame
+                    if (!newFrame) _sampleStats.add(_servo[i].getLate(), _servo[i].getMissed());
+#endif
+                    newFrame = true;
+                }
+            }
+            if (newFrame) _commitFrame();
+            if (elapsed >= _motionDuration) _endMotion();
+            break;
+
+        case MOTION_MOVE:
+        case MOTION_KEYFRAMES:
+            elapsed = now - _moveStart;
+            if (elapsed >= _moveDuration) {
+                for (uint8_t i=0; i<N; i++) {
+                    _servo[i].SetPosition(_servo_target[i]);
+                    _servo_position[i] = _servo_target[i];
+                }
+                _commitFrame();
+                //-- The next keyframe starts exactly at the end of this one
+                if ((_motionType == MOTION_KEYFRAMES) && (++_kfIndex < _kfCount)) _nextKeyframe(_moveStart + _moveDuration);
+                else if ((_motionType == MOTION_KEYFRAMES) && (--_kfRepeat > 0)) {
+                    _kfIndex = 0;
+                    _nextKeyframe(_moveStart + _moveDuration);
+                }
+                else _endMotion();
+            }
+            else if ((now - _lastFrame) >= MOTION_FRAME_TIME) {
+                _lastFrame = now;
+                //-- Progress of the move from the elapsed time (65536 = done)
+                uint32_t s = _profile(_moveProfile, (elapsed * _moveRate) >> 16);
+                for (uint8_t i=0; i<N; i++) {
+                    int16_t delta = (int16_t)_servo_target[i] - _servo_start[i];
+                    _servo_position[i] = _servo_start[i] + (int16_t)(((int32_t)delta * (int32_t)s + 0x8000) >> 16);
+                    _servo[i].SetPosition(_servo_position[i]);
+                }
+                _commitFrame();
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return isMoving();
+}
 
+/**
+ * @brief Stop the current motion where it is and drop the queued ones.
+ * The servos stay at the positions reached and the next motion starts
+ * from them.
+ * 
+ * @tparam N Number of Servo
+ */
+template <uint8_t N>
+void OttoServo<N>::stopMotion()
+{
+    _queueCount = 0;
+    if (_motionType == MOTION_IDLE) return;
+
+    //-- Positions reached by the oscillators, for the next move
+    if (_motionType == MOTION_OSCILLATE) {
+        for (uint8_t i=0; i<N; i++) _servo_position[i] = _servo[i].getPosition();
+    }
+    _detachOnDone = false;
+    _motionStart = millis();
+    _motionDuration = 0;
+    _endMotion();
+}
+
+/**
+ * @brief Time left before update(), or the stream (see setStreamFrame),
+ * has a frame to output. Used by the scheduler to keep the other tasks from delaying the servos.
+ * 
+ * @tparam N Number of Servo
+ * @return uint16_t Time (ms), 0 if the frame is due, 0xFFFF when idle
+ */
+template <uint8_t N>
+uint16_t OttoServo<N>::nextFrame()
+{
+    uint32_t due;
+
+    switch(_motionType) {
+        case MOTION_OSCILLATE:
+            due = _motionStart + _motionDuration;
+            for (uint8_t i=0; i<N; i++) {
+                uint32_t t = _servo[i].getNextSample();
+                if ((int32_t)(t - due) < 0) due = t;
+            }
+            break;
+
+        case MOTION_MOVE:
+        case MOTION_KEYFRAMES:
+            due = _moveStart + _moveDuration;
+            if ((int32_t)(_lastFrame + MOTION_FRAME_TIME - due) < 0) due = _lastFrame + MOTION_FRAME_TIME;
+            break;
+
+        default:
+            //-- Idle: the next frame of a stream, if any
+            if (!_streaming) return 0xFFFF;
+            due = _streamFrame;
+            break;
+    }
+
+    int32_t left = (int32_t)(due - millis());
+    if (left <= 0) return 0;
+    return (left < 0xFFFF) ? left : 0xFFFF;
+}
+
+/**
+ * @brief Change the period of the current oscillation.
+ * The number of remaining cycles is kept and the change is crossfaded
+ * over the blend time (see setBlendTime).
+ * 
+ * @tparam N Number of Servo
+ * @param T New period (ms)
+ */
+template <uint8_t N>
+void OttoServo<N>::setPeriod(uint16_t T)
+{
+    if ((_motionType != MOTION_OSCILLATE) || (T == 0) || (T == _motionT)) return;
+
+    uint32_t now = millis();
+    uint32_t elapsed = now - _motionStart;
+    uint32_t remaining = (elapsed < _motionDuration) ? (_motionDuration - elapsed) : 0;
+
+    for (uint8_t i=0; i<N; i++) {
+        _servo[i].StartBlend(now, _blendTime);
+        _servo[i].SetT(T);
+    }
+    //-- remaining * T / _motionT in integers, without overflow on long motions
+    _motionDuration = elapsed + (remaining / _motionT) * T + (remaining % _motionT) * T / _motionT;
+    _motionT = T;
+}
+
+/**
+ * @brief Reserve the next free command of the motion queue.
+ * If the queue is full, the motion engine runs until a command is free.
+ * 
+ * @tparam N Number of Servo
+ * @param type      MOTION_OSCILLATE / MOTION_MOVE
+ * @param duration  Duration of the motion (ms)
+ * @return MotionCommand* Command to fill, then push with _queueMotion()
+ */
+template <uint8_t N>
+typename OttoServo<N>::MotionCommand *OttoServo<N>::_newMotion(uint8_t type, uint32_t duration)
+{
+    while (_queueCount >= MOTION_QUEUE_SIZE) _waitFrame();
+
+    MotionCommand *cmd = &_queue[(_queueHead + _queueCount) % MOTION_QUEUE_SIZE];
+    cmd->type = type;
+    cmd->home = false;
+    cmd->profile = _defaultProfile;
+    cmd->duration = duration;
+#ifdef __USE_TELEMETRY
+    cmd->gait = GAIT_CUSTOM;
+#endif
+    return cmd;
+}
+
+/**
+ * @brief Push the command reserved by _newMotion() in the motion queue.
+ * The command starts immediately if Otto is idle.
+ * 
+ * @tparam N Number of Servo
+ */
+template <uint8_t N>
+void OttoServo<N>::_queueMotion()
+{
+    _queueCount++;
+
+    if (_motionType == MOTION_IDLE) {
+        //-- Chain with the previous motion if it has just ended, so that
+        //-- successive blocking calls are continuous
+        uint32_t now = millis();
+        _startMotion(((now - _motionEnd) < MOTION_FRAME_TIME) ? _motionEnd : now);
+    }
+
+    if(_blocking) _waitMotion();
+}
+
+/**
+ * @brief Start the first command of the motion queue
+ * 
+ * @tparam N Number of Servo
+ * @param t0 Start time of the motion (ms)
+ */
+template <uint8_t N>
+void OttoServo<N>::_startMotion(uint32_t t0)
+{
+    MotionCommand *cmd = &_queue[_queueHead];
+
+    attachServos();
+    _isOttoResting = false;
+
+    _motionStart = t0;
+    _motionDuration = cmd->duration;
+    _detachOnDone = cmd->home;
+#ifdef __USE_TELEMETRY
+    _gait = cmd->gait;
+#endif
+
+    if (cmd->type == MOTION_OSCILLATE) {
+        //-- An oscillation following another one without a break
+        //-- crossfades from it, keeping the phase running
+        bool blend = (_blendTime > 0) && (_prevMotionType == MOTION_OSCILLATE) && (t0 == _motionEnd);
+        for (uint8_t i=0; i<N; i++) {
+            if (blend) _servo[i].StartBlend(t0, _blendTime);
+            _servo[i].SetO(cmd->O[i]);
+            _servo[i].SetA(cmd->A[i]);
+            _servo[i].SetT(cmd->T);
+            _servo[i].SetPhase(cmd->phase[i]);
+            //-- Same time origin for all the joints
+            if (!blend) _servo[i].Reset(t0);
+        }
+        _motionT = cmd->T;
+    }
+    else if (cmd->type == MOTION_KEYFRAMES) {
+        _kfFrames = cmd->frames;
+        _kfCount = cmd->count;
+        _kfRepeat = cmd->repeat;
+        _kfT = cmd->T;
+        _kfIndex = 0;
+        _nextKeyframe(t0);
+    }
+    else {
+        for (uint8_t i=0; i<N; i++) _servo_target[i] = cmd->O[i];
+        //-- Short motions are applied at the next update()
+        if (_motionDuration <= MOTION_FRAME_TIME) _motionDuration = 0;
+        _startMove(t0, _motionDuration, cmd->profile);
+    }
+    _motionType = cmd->type;
+
+    _queueHead = (_queueHead + 1) % MOTION_QUEUE_SIZE;
+    _queueCount--;
+}
+
+/**
+ * @brief Terminate the current motion and start the next queued one
+ * exactly at the end time of the current motion
+ * 
+ * @tparam N Number of Servo
+ */
+template <uint8_t N>
+void OttoServo<N>::_endMotion()
+{
+    _motionEnd = _motionStart + _motionDuration;
+    _prevMotionType = _motionType;
+    _motionType = MOTION_IDLE;
+
+    if (_detachOnDone) {
+        _detachOnDone = false;
         detachServos();
         _isOttoResting = true;
     }
+
+    if (_queueCount > 0) _startMotion(_motionEnd);
+
+    if (_motionCallback != NULL) _motionCallback();
+}
+
+/**
+ * @brief Start a move from the current positions to _servo_target
+ * 
+ * @tparam N Number of Servo
+ * @param t0        Start time of the move (ms)
+ * @param duration  Duration of the move (ms)
+ * @param profile   MOVE_LINEAR / MOVE_TRAPEZOID / MOVE_MIN_JERK
+ */
+template <uint8_t N>
+void OttoServo<N>::_startMove(uint32_t t0, uint32_t duration, uint8_t profile)
+{
+    for (uint8_t i=0; i<N; i++) _servo_start[i] = _servo_position[i];
+    _moveStart = t0;
+    _moveDuration = duration;
+    _moveProfile = profile;
+    _lastFrame = t0;
+    if (duration > 0) _moveRate = 0xFFFFFFFFUL / duration;
+}
+
+/**
+ * @brief Start the keyframe _kfIndex of the current animation
+ * 
+ * @tparam N Number of Servo
+ * @param t0 Start time of the keyframe (ms)
+ */
+template <uint8_t N>
+void OttoServo<N>::_nextKeyframe(uint32_t t0)
+{
+    OttoKeyframe frame;
+
+    memcpy_P(&frame, &_kfFrames[_kfIndex], sizeof(OttoKeyframe));
+    for (uint8_t i=0; i<N; i++) {
+        if ((i < OTTO_GAIT_JOINTS) && (frame.pose[i] != KEYFRAME_KEEP)) _servo_target[i] = frame.pose[i];
+        else _servo_target[i] = _servo_position[i];
+    }
+    _startMove(t0, _keyframeTime(&_kfFrames[_kfIndex], _kfT), (frame.ease == MOVE_DEFAULT) ? _defaultProfile : frame.ease);
+}
+
+/**
+ * @brief Duration of a keyframe
+ * 
+ * @tparam N Number of Servo
+ * @param frame Keyframe (PROGMEM)
+ * @param T     Period of the animation (ms)
+ * @return uint32_t Duration (ms)
+ */
+template <uint8_t N>
+uint32_t OttoServo<N>::_keyframeTime(const OttoKeyframe *frame, uint16_t T)
+{
+    uint16_t time = pgm_read_word(&frame->time);
+
+    if (time & KEYFRAME_T_RELATIVE) return ((uint32_t)T * (time & ~KEYFRAME_T_RELATIVE)) / 1000;
+    return time;
+}
+
+/**
+ * @brief Motion profile: position from the time progress of a move
+ * 
+ * @tparam N Number of Servo
+ * @param profile   MOVE_LINEAR / MOVE_TRAPEZOID / MOVE_MIN_JERK
+ * @param u         Time progress (0 to 65535)
+ * @return uint32_t Position progress (0 to 65536)
+ */
+template <uint8_t N>
+uint32_t OttoServo<N>::_profile(uint8_t profile, uint32_t u)
+{
+    uint32_t u2;
+
+    switch (profile) {
+        case MOVE_TRAPEZOID:
+            //-- Speed 4/3 reached after 1/4 of the time:
+            //-- s = 8/3.u^2, 4/3.(u - 1/8), 1 - 8/3.(1 - u)^2
+            if (u < 16384) {
+                u2 = (u * u) >> 16;
+                return (u2 * 174763UL) >> 16;
+            }
+            if (u < 49152) return ((u - 8192) * 87381UL) >> 16;
+            u2 = ((65536 - u) * (65536 - u)) >> 16;
+            return 65536 - ((u2 * 174763UL) >> 16);
+
+        case MOVE_MIN_JERK:
+            //-- s = u^3.(10 - 15.u + 6.u^2)
+            u2 = (u * u) >> 16;
+            return (((u2 * u) >> 16) * ((655360UL - 15 * u + 6 * u2) >> 4)) >> 12;
+
+        default:
+            return u;
+    }
+}
+
+/**
+ * @brief Output the positions of all the Servo at once (ServoTimer backend)
+ * and log the frame in the telemetry
+ * 
+ * @tparam N Number of Servo
+ */
+template <uint8_t N>
+void OttoServo<N>::_commitFrame()
+{
+#ifdef __USE_SERVO_TIMER
+    ServoTimer::commit();
+#endif
+#ifdef __USE_TELEMETRY
+    if (_motionType == MOTION_OSCILLATE) {
+        //-- The oscillators do not update _servo_position
+        uint8_t position[N];
+        for (uint8_t i=0; i<N; i++) position[i] = _servo[i].getPosition();
+        OttoTelemetry::logFrame(position, N, _motionType, _gait);
+    }
+    else OttoTelemetry::logFrame(_servo_position, N, _motionType, GAIT_CUSTOM);
+#endif
+}
+
+/**
+ * @brief Run the motion engine until all the queued motions are completed
+ * 
+ * @tparam N Number of Servo
+ */
+template <uint8_t N>
+void OttoServo<N>::_waitMotion()
+{
+    while (_waitFrame());
+}
+
+/**
+ * @brief One step of a blocking wait: the motion engine, then the wait hook
+ * 
+ * @tparam N Number of Servo
+ * @return true     Otto is moving
+ */
+template <uint8_t N>
+bool OttoServo<N>::_waitFrame()
+{
+    bool moving = update();
+    if (_waitHook != NULL) _waitHook(_waitContext);
+    return moving;
 }
 
 #endif //OTTOSERVO_h
@@ -23,6 +23,71 @@
 #include "OttoSoundSong.h"
 #include "OttoSound.h"
 
+#ifndef __USE_TONE_TIMER
+//-- Period (us) of the notes of octave 0 (C0 to B0), computed at compile time.
+//-- The higher octaves are obtained by shifting.
+#define _KEY_PERIOD(f0)     ((uint16_t)(1000000.0 / (f0) + 0.5))
+static const uint16_t _keyPeriod[12] PROGMEM = {
+    _KEY_PERIOD(note_C0), _KEY_PERIOD(note_Db0), _KEY_PERIOD(note_D0), _KEY_PERIOD(note_Eb0),
+    _KEY_PERIOD(note_E0), _KEY_PERIOD(note_F0), _KEY_PERIOD(note_Gb0), _KEY_PERIOD(note_G0),
+    _KEY_PERIOD(note_Ab0), _KEY_PERIOD(note_A0), _KEY_PERIOD(note_Bb0), _KEY_PERIOD(note_B0)
+};
+
+//-- High part of the period for the volumes 1 to 10 (1/65536 period)
+static const uint16_t _volumeSplit[10] PROGMEM = {257, 328, 437, 524, 655, 753, 1311, 1986, 2979, 32768};
+
+/**
+ * @brief Period of a note
+ * 
+ * @param key       Key number of the note (see OttoSoundNote.h)
+ * @return uint16_t Period (us), 0 for a rest
+ */
+static uint16_t _keyToPeriod(uint8_t key)
+{
+    uint8_t octave = key / 12;
+    if (octave > 8) return 0;
+
+    uint16_t period = pgm_read_word(&_keyPeriod[key % 12]);
+    return octave ? ((period >> (octave - 1)) + 1) >> 1 : period;
+}
+
+/**
+ * @brief Period of a frequency
+ * 
+ * @param freq      Frequency (Hz << 8)
+ * @return uint16_t Period (us), 0 for a rest
+ */
+static uint16_t _freqToPeriod(uint32_t freq)
+{
+    if (freq == 0) return 0;
+    //-- Longest period below 15.3 Hz
+    return (freq >= 3907) ? (uint16_t)((256000000UL + freq / 2) / freq) : 0xFFFF;
+}
+#endif
+
+/**
+ * @brief Next frequency of a bend: freq * ratio / 4096, without overflow
+ * 
+ * @param freq      Frequency (Hz << 8)
+ * @param ratio     Ratio of the step (1/4096)
+ * @return uint32_t Frequency (Hz << 8)
+ */
+static uint32_t _bendStep(uint32_t freq, uint16_t ratio)
+{
+    return (freq >> 12) * ratio + (((freq & 0xFFF) * ratio) >> 12);
+}
+
+//-- Phrases of r2d2(): number of phrases << 5 | phrase of each one
+//-- (bit n: 0 = phrase 1, 1 = phrase 2)
+static const uint8_t _r2d2Phrases[6] PROGMEM = {
+    (1 << 5) | 0x00,    //-- 1
+    (1 << 5) | 0x01,    //-- 2
+    (2 << 5) | 0x02,    //-- 1 2
+    (3 << 5) | 0x02,    //-- 1 2 1
+    (5 << 5) | 0x0A,    //-- 1 2 1 2 1
+    (3 << 5) | 0x05     //-- 2 1 2
+};
+
 /**
  * @brief Construct a new OttoSound::OttoSound object
  * 
@@ -32,6 +97,11 @@ OttoSound::OttoSound(uint8_t pinBuzzer)
 {
     _pinBuzzer = pinBuzzer;
     pinMode(_pinBuzzer, OUTPUT);
+    _songPlaying = false;
+    _r2d2Playing = false;
+#ifdef __USE_TONE_TIMER
+    ToneTimer::begin(_pinBuzzer);
+#endif
 }
 
 /**
@@ -43,26 +113,86 @@ OttoSound::~OttoSound()
 }
 
 /**
- * @brief Play a note on buzzer pin.
+ * @brief Play a note on buzzer pin, without float math.
+ * With __USE_TONE_TIMER (see ToneTimer.h), the note is only queued.
+ * 
+ * @param noteFrequency     : Note frequency (Hz), 0 or less for silence
+ * @param noteDuration      : Note duration (ms)
+ * @param silentDuration    : Duration of silence after note (ms)
+ * @param volume            : volume control (1 to 10)
+ */
+void OttoSound::_tone (int32_t noteFrequency, uint32_t noteDuration, uint16_t silentDuration, uint8_t volume)
+{
+    if (noteFrequency < 0) noteFrequency = 0;
+#ifdef __USE_TONE_TIMER
+    ToneTimer::play(min(noteFrequency, 0xFFFFL), min(noteDuration, 0xFFFFUL), volume);
+    ToneTimer::play(0, silentDuration, 0);
+#else
+    _tonePeriod(_freqToPeriod(min(noteFrequency, 0xFFFFL) << 8), noteDuration, silentDuration, volume);
+#endif //__USE_TONE_TIMER
+}
+
+/**
+ * @brief Play a note by key number, without float math: the period and the
+ * volume split come from tables.
+ * With __USE_TONE_TIMER (see ToneTimer.h), the note is only queued.
  * 
- * @param noteFrequency     : Note frequency (Hz)
+ * @param key               : Key number of the note (key_C4, key_Ab3... key_R for a rest)
  * @param noteDuration      : Note duration (ms)
  * @param silentDuration    : Duration of silence after note (ms)
  * @param volume            : volume control (1 to 10)
+ * 
+ * @example 
+ *      playNote(key_A4, 500);
  */
-void OttoSound::_tone (float noteFrequency, uint32_t noteDuration, uint16_t silentDuration, uint8_t volume)
+void OttoSound::playNote(uint8_t key, uint16_t noteDuration, uint16_t silentDuration, uint8_t volume)
 {
-    const uint8_t _tftVolume[] = { 255, 200, 150, 125, 100, 87, 50, 33, 22, 2 }; // Duty for linear volume control.
+#ifdef __USE_TONE_TIMER
+    ToneTimer::playKey(key, noteDuration, volume);
+    ToneTimer::play(0, silentDuration, 0);
+#else
+    _tonePeriod(_keyToPeriod(key), noteDuration, silentDuration, volume);
+#endif //__USE_TONE_TIMER
+}
 
-    if(noteFrequency == 0 || volume == 0) {
+/**
+ * @brief Play a note followed by a silence count times.
+ * With __USE_TONE_TIMER, the repeats are a single gated note in the queue.
+ * 
+ * @param key               : Key number of the note
+ * @param noteDuration      : Note duration (ms)
+ * @param silentDuration    : Duration of silence after each note (ms)
+ * @param count             : Number of repeats
+ */
+void OttoSound::_repeatNote(uint8_t key, uint16_t noteDuration, uint16_t silentDuration, uint8_t count)
+{
+#ifdef __USE_TONE_TIMER
+    ToneTimer::repeatKey(key, noteDuration, silentDuration, count, 10);
+#else
+    while (count--) playNote(key, noteDuration, silentDuration);
+#endif //__USE_TONE_TIMER
+}
+
+#ifndef __USE_TONE_TIMER
+/**
+ * @brief Play a square wave on buzzer pin.
+ * 
+ * @param period            : Period of the wave (us), 0 for silence
+ * @param noteDuration      : Note duration (ms)
+ * @param silentDuration    : Duration of silence after note (ms)
+ * @param volume            : volume control (1 to 10)
+ */
+void OttoSound::_tonePeriod(uint16_t period, uint32_t noteDuration, uint16_t silentDuration, uint8_t volume)
+{
+    if(period == 0 || volume == 0) {
         //Wait for the duration of the note if frequency or volume are zero
 		delay(noteDuration);
 	} else {
 #ifdef __USE_ARDUINO_TONE_LIB
-        tone(_pinBuzzer,(uint16_t)noteFrequency, noteDuration);
+        tone(_pinBuzzer, (1000000UL + period / 2) / period, noteDuration);
 #else
-        uint32_t period = (uint32_t)(1000000 / noteFrequency); //Calculate the square wave length (in microseconds).
-        uint32_t duty = period / _tftVolume[min(volume, 10) - 1]; // Calculate the duty cycle (volume).
+        //-- High part of the period (volume)
+        uint16_t duty = ((uint32_t)period * pgm_read_word(&_volumeSplit[min(volume, 10) - 1])) >> 16;
         uint32_t startTime = millis();
         while(millis() < (startTime + noteDuration)) {
             digitalWrite(_pinBuzzer,HIGH);  // Set pin high.
@@ -81,9 +211,12 @@ void OttoSound::_tone (float noteFrequency, uint32_t noteDuration, uint16_t sile
       
     if(silentDuration) delay(silentDuration);  
 }
+#endif //__USE_TONE_TIMER
 
 /**
  * @brief Play a note with a bend effect.
+ * With __USE_TONE_TIMER, the bend is one sweep queued to the tone timer: the
+ * frequency glides, and the silences become the gaps of the sweep.
  * 
  * @param initFrequency     : Initial note frequency (Hz)
  * @param finalFrequency    : Final note frequency (Hz)
@@ -97,11 +230,45 @@ void OttoSound::_tone (float noteFrequency, uint32_t noteDuration, uint16_t sile
  */
 void OttoSound::bendTones (float initFrequency, float finalFrequency, float prop, long noteDuration, int silentDuration)
 {
-    if(initFrequency < finalFrequency) {
-        for (float freq=initFrequency; freq<finalFrequency; freq=(freq*prop)) _tone(freq, noteDuration, silentDuration);
-    } else {
-        for (float freq=initFrequency; freq>finalFrequency; freq=(freq/prop)) _tone(freq, noteDuration, silentDuration);
+    if (prop <= 1 || initFrequency <= 0 || finalFrequency <= 0) return;
+
+    //-- The steps are integer: frequencies in Hz << 8, ratio in 1/4096,
+    //-- at least one 4096th so that the bend always progresses
+    bool up = initFrequency < finalFrequency;
+    uint32_t freq = initFrequency * 256 + 0.5;
+    uint32_t last = finalFrequency * 256 + 0.5;
+    uint16_t ratio = up ? constrain(prop * 4096 + 0.5, 4097, 65535) : constrain(4096 / prop + 0.5, 1, 4095);
+
+    //-- Durations of the tone functions, clamped instead of truncated
+    uint16_t note = constrain(noteDuration, 0L, 0xFFFFL);
+    uint16_t silence = constrain(silentDuration, 0, 0x7FFF);
+
+#ifdef __USE_TONE_TIMER
+    //-- Sweeps through the same frequencies, at the same times: it reaches
+    //-- freq * prop at the start of each step, and sounds during noteDuration
+    //-- of each step when there is a silence. A long bend is split on the
+    //-- steps in several sweeps of 65535 ms at most.
+    uint16_t stepTime = min((uint32_t)note + silence, 0xFFFFUL);
+    if (stepTime == 0) return;
+
+    uint16_t chunk = 0xFFFF / stepTime;
+    uint16_t on = silence ? stepTime - silence : 0;
+    uint16_t steps = 0;
+    uint32_t start = freq;
+
+    while (up ? (freq < last) : (freq > last)) {
+        freq = _bendStep(freq, ratio);
+        if ((++steps == chunk) || (up ? (freq >= last) : (freq <= last))) {
+            ToneTimer::sweep((start + 128) >> 8, (freq + 128) >> 8, steps * stepTime, 10, on, silence);
+            start = freq;
+            steps = 0;
+        }
+    }
+#else
+    for (; up ? (freq < last) : (freq > last); freq = _bendStep(freq, ratio)) {
+        _tonePeriod(_freqToPeriod(freq), note, silence, 10);
     }
+#endif //__USE_TONE_TIMER
 }
 
 /**
@@ -111,23 +278,25 @@ void OttoSound::bendTones (float initFrequency, float finalFrequency, float prop
  */
 void OttoSound::sing(uint8_t songName)
 {
+    uint8_t count;
+
     switch(songName) 
     {
         case S_connection:
-            _tone(note_E5,50,30);
-            _tone(note_E6,55,25);
-            _tone(note_A6,60,10);
+            playNote(key_E5, 50, 30);
+            playNote(key_E6, 55, 25);
+            playNote(key_A6, 60, 10);
             break;
 
         case S_disconnection:
-            _tone(note_E5,50,30);
-            _tone(note_A6,55,25);
-            _tone(note_E6,50,10);
+            playNote(key_E5, 50, 30);
+            playNote(key_A6, 55, 25);
+            playNote(key_E6, 50, 10);
             break;
 
         case S_buttonPushed:
             bendTones (note_E6, note_G6, 1.03, 20, 2);
-            delay(30);
+            playNote(key_R, 30, 0);
             bendTones (note_E6, note_D7, 1.04, 10, 2);
             break;
 
@@ -140,9 +309,9 @@ void OttoSound::sing(uint8_t songName)
             break;
 
         case S_mode3:
-            _tone(note_E6,50,100); //D6
-            _tone(note_G6,50,80);  //E6
-            _tone(note_D7,300,0);  //G6
+            playNote(key_E6, 50, 100); //D6
+            playNote(key_G6, 50, 80);  //E6
+            playNote(key_D7, 300, 0);  //G6
             break;
 
         case S_surprise:
@@ -152,18 +321,18 @@ void OttoSound::sing(uint8_t songName)
 
         case S_OhOoh:
             bendTones(880, 2000, 1.04, 8, 3); //A5 = 880
-            delay(200);
-            for (int i=880; i<2000; i=i*1.04) {
-                _tone(note_B5,5,10);
-            }
+            playNote(key_R, 200, 0);
+            count = 0;
+            for (int i=880; i<2000; i+=i/25) count++;
+            _repeatNote(key_B5, 5, 10, count);
             break;
 
         case S_OhOoh2:
             bendTones(1880, 3000, 1.03, 8, 3);
-            delay(200);
-            for (int i=1880; i<3000; i=i*1.03) {
-                _tone(note_C6,10,10);
-            }
+            playNote(key_R, 200, 0);
+            count = 0;
+            for (int i=1880; i<3000; i+=i*3/100) count++;
+            _repeatNote(key_C6, 10, 10, count);
             break;
 
         case S_cuddly:
@@ -173,7 +342,7 @@ void OttoSound::sing(uint8_t songName)
 
         case S_sleeping:
             bendTones(100, 500, 1.04, 10, 10);
-            delay(500);
+            playNote(key_R, 500, 0);
             bendTones(400, 100, 1.04, 10, 1);
             break;
 
@@ -184,13 +353,13 @@ void OttoSound::sing(uint8_t songName)
 
         case S_superHappy:
             bendTones(2000, 6000, 1.05, 8, 3);
-            delay(50);
+            playNote(key_R, 50, 0);
             bendTones(5999, 2000, 1.05, 13, 2);
             break;
 
         case S_happy_short:
             bendTones(1500, 2000, 1.05, 15, 8);
-            delay(100);
+            playNote(key_R, 100, 0);
             bendTones(1900, 2500, 1.05, 10, 8);
             break;
 
@@ -224,172 +393,294 @@ void OttoSound::sing(uint8_t songName)
 }
 
 /**
- * @brief 
+ * @brief R2D2 sound: random phrases of glides, then random beeps.
+ * With __USE_TONE_TIMER, the sound is streamed to the queue by updateSound(),
+ * like the songs.
  * 
  */
 void OttoSound::r2d2()
 {
-    switch (random(1,7)) {
-        case 1: _r2d2Phrase1(); break;
-        case 2: _r2d2Phrase2(); break;
-        case 3: _r2d2Phrase1(); _r2d2Phrase2(); break;
-        case 4: _r2d2Phrase1(); _r2d2Phrase2(); _r2d2Phrase1(); break;
-        case 5: _r2d2Phrase1(); _r2d2Phrase2(); _r2d2Phrase1(); _r2d2Phrase2(); _r2d2Phrase1(); break;
-        case 6: _r2d2Phrase2(); _r2d2Phrase1(); _r2d2Phrase2(); break;
+    _r2d2Sequence = pgm_read_byte(&_r2d2Phrases[random(1,7) - 1]);
+    _r2d2Glide = 0;
+    _r2d2Beep = 0;
+    _r2d2Playing = true;
+
+#ifdef __USE_TONE_TIMER
+    _r2d2Queue();
+#else
+    while (_r2d2Next());
+#endif
+}
+
+/**
+ * @brief Play or queue the next part of the R2D2 sound: a glide, a beep,
+ * or the final rest
+ * 
+ * @return true     The sound goes on, false at the end
+ */
+bool OttoSound::_r2d2Next()
+{
+    if (!_r2d2Playing) return false;
+
+    if (_r2d2Glide < 2 * (_r2d2Sequence >> 5)) {
+        //-- Phrase 1 glides down slowly then up fast, phrase 2 the opposite
+        uint8_t fast = _r2d2Glide & 1;
+        bool down = ((_r2d2Sequence >> (_r2d2Glide / 2)) & 1) == fast;
+        if (!fast) _r2d2Key = random(1000,2000);
+        _r2d2Slide((fast ? 10 : 2) * (down ? -1 : 1), fast ? 1000 : 2000);
+        _r2d2Glide++;
+        return true;
+    }
+    if (_r2d2Beep <= random(3, 9)) {
+        uint16_t freq = random(300, 4000);
+        uint16_t note = random(70, 170);
+        _tone(freq, note, random(0, 30));
+        _r2d2Beep++;
+        return true;
     }
-    for (int i=0; i<=random(3, 9); i++) {
-        float freq = random(300, 4000);
-        // tone(_pinBuzzer, freq);          
-        // delay(random(70, 170));           
-        // noTone(_pinBuzzer);         
-        // delay(random(0, 30)); 
-        _tone(freq,random(70, 170),random(0, 30));
-    } 
-    noTone(_pinBuzzer); 
-    delay(2);
+    playNote(key_R, 2, 0);
+    _r2d2Playing = false;
+    return false;
 }
 
 /**
- * @brief 
+ * @brief Glide of the R2D2 sound: step i plays _r2d2Key + slope * i during
+ * 0 or 1 ms, while i is not above random(100, max)
+ * With __USE_TONE_TIMER, the steps are queued as one sweep and one silence
+ * (the frequencies below 1 Hz)
  * 
+ * @param slope     Frequency change per step (Hz)
+ * @param max       Largest number of steps
  */
-void OttoSound::_r2d2Phrase1()
+void OttoSound::_r2d2Slide(int8_t slope, uint16_t max)
 {
-    uint16_t k = random(1000,2000);
-    
-    for (uint16_t i = 0; i <=  random(100,2000); i++) {
-        // tone(_pinBuzzer, k+(-i*2));          
-        // delay(random(.9,2));     
-        _tone(k+(-i*2),random(.9,2),0);
-    } 
-      
-    for (uint16_t i = 0; i <= random(100,1000); i++) {
-        // tone(_pinBuzzer, k + (i * 10));          
-        // delay(random(.9,2)); 
-        _tone(k+(i*10),random(.9,2),0);            
-    } 
+#ifdef __USE_TONE_TIMER
+    uint16_t sound = 0;
+    uint16_t silence = 0;
+    int32_t last = _r2d2Key;
+
+    for (uint16_t i = 0; i <= random(100, max); i++) {
+        int32_t freq = _r2d2Key + (int32_t)slope * i;
+        uint8_t time = random(0, 2);
+        if (freq > 0) {
+            sound += time;
+            last = freq;
+        }
+        else silence += time;
+    }
+    ToneTimer::sweep(_r2d2Key, last, sound, 10);
+    ToneTimer::play(0, silence, 0);
+#else
+    for (uint16_t i = 0; i <= random(100, max); i++) {
+        _tone(_r2d2Key + (int32_t)slope * i, random(0, 2), 0);
+    }
+#endif //__USE_TONE_TIMER
 }
 
+#ifdef __USE_TONE_TIMER
 /**
- * @brief 
+ * @brief Queue the next parts of the R2D2 sound while there is room
  * 
  */
-void OttoSound::_r2d2Phrase2()
+void OttoSound::_r2d2Queue()
 {
-    uint16_t k = random(1000,2000);
-
-    for (uint16_t i = 0; i <= random(100,2000); i++) {
-        // tone(_pinBuzzer, k+(i*2));          
-        // delay(random(.9,2));
-        _tone(k+(i*2),random(.9,2),0);
-    } 
-  
-    for (uint16_t i = 0; i <= random(100,1000); i++) {
-        // tone(_pinBuzzer, k + (-i * 10));          
-        // delay(random(.9,2)); 
-        _tone(k+(-i*10),random(.9,2),0);
-    } 
+    //-- A part takes two notes at most
+    while (ToneTimer::queueFree() >= 2 && _r2d2Next());
 }
+#endif //__USE_TONE_TIMER
 
 
 /**
- * @brief 
+ * @brief Play the Silent Night song
  * 
  */
 void OttoSound::songSilentNight(void)
 {
-    int lead_note_count = sizeof(Silent_night_lead_notes) / sizeof(float);
-    int bass_note_count = sizeof(Silent_night_bass_notes) / sizeof(float);
-    int curr_lead_note = 0;
-    int curr_bass_note = 0;
-    uint16_t curr_lead_note_duration_remaining = Silent_night_lead_duration[curr_lead_note];
-    uint16_t curr_bass_note_duration_remaining = 1500;
-    float lead_freq, bass_freq;
-    uint16_t duration;
-
-    while (curr_lead_note < lead_note_count && curr_bass_note < bass_note_count) {
-        lead_freq = Silent_night_lead_notes[curr_lead_note];
-        bass_freq = Silent_night_bass_notes[curr_bass_note];
-        duration = min(curr_lead_note_duration_remaining, curr_bass_note_duration_remaining);
-
-        if (lead_freq > 0 && bass_freq > 0) {
-            //play_two_notes(lead_freq, bass_freq, duration);
-            for (unsigned long t=0; t<duration; t+=2*(POLY_DELTA+1)) {
-                _tone(lead_freq, POLY_DELTA, 1);
-                _tone(bass_freq, POLY_DELTA, 1);
-            }
-        } else if (lead_freq > 0) {
-            //play_one_note(lead_freq, duration);
-            _tone(lead_freq, duration, 1);
-        } else if (bass_freq > 0) {
-            //play_one_note(bass_freq, duration);
-            _tone(bass_freq, duration, 1);
-        } else {
-            delay( duration );
-        }
-        // Advance lead note
-        curr_lead_note_duration_remaining -= duration;
-        if(curr_lead_note_duration_remaining < 1) {
-            curr_lead_note++;
-            curr_lead_note_duration_remaining = Silent_night_lead_duration[curr_lead_note];
-        }
-        // Advance bass note
-        curr_bass_note_duration_remaining -= duration;
-        if(curr_bass_note_duration_remaining < 1) {
-            curr_bass_note++;
-            curr_bass_note_duration_remaining = 1500;
-        }
-        
-    } 
+    playSong(&song_silent_night);
 }
 
 /**
- * @brief 
+ * @brief Play the Tetris song
  * 
  */
 void OttoSound::songTetris(void)
 {
-    int lead_note_count = sizeof(tetris_lead_notes) / sizeof(float);
-    int bass_note_count = sizeof(tetris_bass_notes) / sizeof(float);
-    int curr_lead_note = 0;
-    int curr_bass_note = 0;
-    uint16_t curr_lead_note_duration_remaining = tetris_lead_duration[curr_lead_note];
-    uint16_t curr_bass_note_duration_remaining = 1500;
-    float lead_freq, bass_freq;
-    uint16_t duration;
-
-    while (curr_lead_note < lead_note_count && curr_bass_note < bass_note_count) {
-        lead_freq = tetris_lead_notes[curr_lead_note];
-        bass_freq = tetris_bass_notes[curr_bass_note];
-        duration = min(curr_lead_note_duration_remaining, curr_bass_note_duration_remaining);
-
-        if (lead_freq > 0 && bass_freq > 0) {
-            //play_two_notes(lead_freq, bass_freq, duration);
-            for (unsigned long t=0; t<duration; t+=2*(POLY_DELTA+1)) {
-                _tone(lead_freq, POLY_DELTA, 1);
-                _tone(bass_freq, POLY_DELTA, 1);
-            }
-        } else if (lead_freq > 0) {
-            //play_one_note(lead_freq, duration);
-            _tone(lead_freq, duration, 1);
-        } else if (bass_freq > 0) {
-            //play_one_note(bass_freq, duration);
-            _tone(bass_freq, duration, 1);
+    playSong(&song_tetris);
+}
+
+/**
+ * @brief Play a song in the packed format (see OttoSong).
+ * With __USE_TONE_TIMER, each voice of the song is streamed to a voice of
+ * the tone timer by updateSound(), which must be called from the main loop.
+ * The blocking motions of Otto and OttoLee call it while they wait, but the
+ * other blocking calls (delay, sing, a blocking distance read) stop the song
+ * once the queued notes are played. Otherwise several notes at the same time are played by slices of POLY_DELTA.
+ * 
+ * @param song      Song stored in PROGMEM
+ */
+void OttoSound::playSong(const OttoSong *song)
+{
+    OttoSong header;
+
+    memcpy_P(&header, song, sizeof(OttoSong));
+    _songUnit = header.unit;
+    _songPlaying = true;
+#ifndef __USE_TONE_TIMER
+    _songTurn = 0;
+#endif
+    for (uint8_t v = 0; v < SONG_VOICES; v++) {
+        _songData[v] = header.voice[v];
+        _songTime[v] = header.unit;
+        if (_songData[v] != NULL) _songNote(v);
+    }
+
+#ifdef __USE_TONE_TIMER
+    _songQueue();
+#else
+    while (_songStep());
+#endif
+}
+
+/**
+ * @brief Read the next note of a voice
+ * 
+ * @param voice 
+ * @return true     A note is available, false at the end of the voice
+ */
+bool OttoSound::_songNote(uint8_t voice)
+{
+    while (_songData[voice] != NULL) {
+        uint8_t code = pgm_read_byte(_songData[voice]++);
+        if (code == SONG_END) {
+            _songData[voice] = NULL;
+        } else if (code & 0x80) {
+            _songTime[voice] = (code & 0x7F) * _songUnit;
         } else {
-            delay( duration );
+            _songKey[voice] = code;
+            _songLeft[voice] = _songTime[voice];
+            if (_songLeft[voice] > 0) return true;
         }
-        // Advance lead note
-        curr_lead_note_duration_remaining -= duration;
-        if(curr_lead_note_duration_remaining < 1) {
-            curr_lead_note++;
-            curr_lead_note_duration_remaining = tetris_lead_duration[curr_lead_note];
+    }
+    return false;
+}
+
+#ifdef __USE_TONE_TIMER
+/**
+ * @brief Add the next notes of each voice of the song to the queue of
+ * the same voice of the tone timer, while there is room
+ * 
+ */
+void OttoSound::_songQueue()
+{
+    bool playing = false;
+
+    for (uint8_t v = 0; v < SONG_VOICES; v++) {
+        if (v >= TONE_VOICES) _songData[v] = NULL;
+        //-- A note and its 1ms of silence
+        while (_songData[v] != NULL && ToneTimer::queueFree(v) >= 2) {
+            if (_songKey[v] == key_R) {
+                ToneTimer::play(0, _songLeft[v], 0, v);
+            } else {
+                ToneTimer::playKey(_songKey[v], _songLeft[v] - 1, 10, v);
+                ToneTimer::play(0, 1, 0, v);
+            }
+            _songNote(v);
         }
-        // Advance bass note
-        curr_bass_note_duration_remaining -= duration;
-        if(curr_bass_note_duration_remaining < 1) {
-            curr_bass_note++;
-            curr_bass_note_duration_remaining = 250;
+        if (_songData[v] != NULL) playing = true;
+    }
+    _songPlaying = playing;
+}
+#else
+/**
+ * @brief Play the next part of the song: until the next note change,
+ * or one slice of POLY_DELTA when several notes are played together
+ * 
+ * @return true     The song goes on, false at the end of the song
+ */
+bool OttoSound::_songStep()
+{
+    uint16_t time = 0xFFFF;
+    uint8_t notes = 0;
+    uint8_t voice = 0;
+
+    if (!_songPlaying) return false;
+
+    for (uint8_t v = 0; v < SONG_VOICES; v++) {
+        if (_songData[v] == NULL) continue;
+        time = min(time, _songLeft[v]);
+        if (_songKey[v] != key_R) {
+            notes++;
+            voice = v;
         }
-        
-    } 
+    }
+    if (time == 0xFFFF) {
+        _songPlaying = false;
+        return false;
+    }
+
+    //-- 1ms of silence after each note
+    uint8_t silence = 1;
+    if (notes > 1) {
+        //-- Several notes: one slice of the next voice
+        time = min(time, POLY_DELTA + 1);
+        do {
+            _songTurn = (_songTurn + 1) % SONG_VOICES;
+        } while (_songData[_songTurn] == NULL || _songKey[_songTurn] == key_R);
+        voice = _songTurn;
+    } else if (notes == 0 || time < _songLeft[voice] || time < 2) {
+        //-- Rest, or the note goes on after a note change in another voice
+        silence = 0;
+    }
+    playNote(notes ? _songKey[voice] : key_R, time - silence, silence);
+
+    for (uint8_t v = 0; v < SONG_VOICES; v++) {
+        if (_songData[v] == NULL) continue;
+        _songLeft[v] -= time;
+        if (_songLeft[v] == 0) _songNote(v);
+    }
+    return true;
+}
+#endif //__USE_TONE_TIMER
+
+/**
+ * @brief Check if a sound is playing
+ * 
+ * @return true     Notes are playing or queued (always false without __USE_TONE_TIMER)
+ */
+bool OttoSound::isSinging()
+{
+#ifdef __USE_TONE_TIMER
+    return ToneTimer::busy() || _songPlaying || _r2d2Playing;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Background sound, to call periodically from loop() with
+ * __USE_TONE_TIMER: streams the song to the note queue and, on the boards
+ * without the tone timer interrupt (not AVR), follows the queue.
+ * Does nothing otherwise.
+ * 
+ */
+void OttoSound::updateSound()
+{
+#ifdef __USE_TONE_TIMER
+    ToneTimer::update();
+    if (_songPlaying) _songQueue();
+    if (_r2d2Playing) _r2d2Queue();
+#endif
+}
+
+/**
+ * @brief Stop the current sound and drop the queued notes
+ * 
+ */
+void OttoSound::stopSound()
+{
+    _songPlaying = false;
+    _r2d2Playing = false;
+#ifdef __USE_TONE_TIMER
+    ToneTimer::stop();
+#endif
 }
@@ -25,10 +25,20 @@
 
 #include <stdint.h>
 #include "OttoSoundNote.h"
+#include "ToneTimer.h"
 
 /** Configuration *************************************************************/
 // #define __USE_ARDUINO_TONE_LIB      1
-#define POLY_DELTA  14
+#define POLY_DELTA  14      //-- Slices of the notes played together (without __USE_TONE_TIMER)
+#define SONG_VOICES 2       //-- Maximum number of voices of a song
+
+/* Song format ****************************************************************/
+//-- Each voice of a song is a list of bytes in PROGMEM:
+//--   key_xx (see OttoSoundNote.h)   Play the note during the current duration
+//--   SONG_T(units)                  Set the duration of the next notes (1 - 127 units)
+//--   SONG_END                       End of the voice
+#define SONG_T(units)   (0x80 | (units))
+#define SONG_END        0x80
 
 /* Song List ******************************************************************/
 #define S_connection 	    0
@@ -55,6 +65,14 @@
 
 /******************************************************************************/
 
+/**
+ * @brief Song stored in PROGMEM, played by OttoSound::playSong()
+ */
+typedef struct {
+    uint16_t unit;                      //-- Duration of one unit (ms)
+    const uint8_t *voice[SONG_VOICES];  //-- Bytes of each voice (PROGMEM), NULL if not used
+} OttoSong;
+
 /**
  * @brief Otto Robot Sound generation
  * 
@@ -63,17 +81,51 @@ class OttoSound
 {
 private:
     uint8_t _pinBuzzer;
-    void _tone (float noteFrequency, uint32_t noteDuration, uint16_t silentDuration, uint8_t volume = 10);
-    void _r2d2Phrase1();
-    void _r2d2Phrase2();
+    void _tone (int32_t noteFrequency, uint32_t noteDuration, uint16_t silentDuration, uint8_t volume = 10);
+#ifndef __USE_TONE_TIMER
+    void _tonePeriod(uint16_t period, uint32_t noteDuration, uint16_t silentDuration, uint8_t volume);
+#endif
+    void _repeatNote(uint8_t key, uint16_t noteDuration, uint16_t silentDuration, uint8_t count);
+
+    //-- R2D2 sound
+    uint8_t _r2d2Sequence;                   //-- Phrases (see _r2d2Phrases)
+    uint8_t _r2d2Glide;                      //-- Glides played, two per phrase
+    uint8_t _r2d2Beep;                       //-- Beeps played
+    uint16_t _r2d2Key;                       //-- Start frequency of the phrase (Hz)
+    bool _r2d2Playing;
+    bool _r2d2Next();
+    void _r2d2Slide(int8_t slope, uint16_t max);
+#ifdef __USE_TONE_TIMER
+    void _r2d2Queue();
+#endif
+
+    //-- Song player
+    const uint8_t *_songData[SONG_VOICES];   //-- Next byte of each voice, NULL when ended
+    uint8_t _songKey[SONG_VOICES];           //-- Current note of each voice
+    uint16_t _songTime[SONG_VOICES];         //-- Duration of the notes of each voice (ms)
+    uint16_t _songLeft[SONG_VOICES];         //-- Time left in the current note (ms)
+    uint16_t _songUnit;
+    bool _songPlaying;
+    bool _songNote(uint8_t voice);
+#ifdef __USE_TONE_TIMER
+    void _songQueue();
+#else
+    uint8_t _songTurn;                       //-- Voice of the current slice
+    bool _songStep();
+#endif
 public:
     OttoSound(uint8_t pinBuzzer);
     ~OttoSound();
+    void playNote(uint8_t key, uint16_t noteDuration, uint16_t silentDuration = 0, uint8_t volume = 10);
     void bendTones(float initFrequency, float finalFrequency, float prop, long noteDuration, int silentDuration);
     void sing(uint8_t songName);
     void r2d2();
     void songSilentNight(void);
     void songTetris(void);
+    void playSong(const OttoSong *song);
+    bool isSinging();
+    void updateSound();
+    void stopSound();
 };
 
 #endif //OTTOSOUND_h
@@ -128,4 +128,107 @@
 #define  note_D8  4698.64   //D8
 #define  note_Eb8 4978.03   //D#8/Eb8
 
+//-- Key number of the notes: semitones from C0 (see OttoSong in OttoSound.h)
+#define  key_R    127       //Rest
+#define  key_C0   0         //C0
+#define  key_Db0  1         //C#0/Db0
+#define  key_D0   2         //D0
+#define  key_Eb0  3         //D#0/Eb0
+#define  key_E0   4         //E0
+#define  key_F0   5         //F0
+#define  key_Gb0  6         //F#0/Gb0
+#define  key_G0   7         //G0
+#define  key_Ab0  8         //G#0/Ab0
+#define  key_A0   9         //A0
+#define  key_Bb0  10        //A#0/Bb0
+#define  key_B0   11        //B0
+#define  key_C1   12        //C1
+#define  key_Db1  13        //C#1/Db1
+#define  key_D1   14        //D1
+#define  key_Eb1  15        //D#1/Eb1
+#define  key_E1   16        //E1
+#define  key_F1   17        //F1
+#define  key_Gb1  18        //F#1/Gb1
+#define  key_G1   19        //G1
+#define  key_Ab1  20        //G#1/Ab1
+#define  key_A1   21        //A1
+#define  key_Bb1  22        //A#1/Bb1
+#define  key_B1   23        //B1
+#define  key_C2   24        //C2
+#define  key_Db2  25        //C#2/Db2
+#define  key_D2   26        //D2
+#define  key_Eb2  27        //D#2/Eb2
+#define  key_E2   28        //E2
+#define  key_F2   29        //F2
+#define  key_Gb2  30        //F#2/Gb2
+#define  key_G2   31        //G2
+#define  key_Ab2  32        //G#2/Ab2
+#define  key_A2   33        //A2
+#define  key_Bb2  34        //A#2/Bb2
+#define  key_B2   35        //B2
+#define  key_C3   36        //C3
+#define  key_Db3  37        //C#3/Db3
+#define  key_D3   38        //D3
+#define  key_Eb3  39        //D#3/Eb3
+#define  key_E3   40        //E3
+#define  key_F3   41        //F3
+#define  key_Gb3  42        //F#3/Gb3
+#define  key_G3   43        //G3
+#define  key_Ab3  44        //G#3/Ab3
+#define  key_A3   45        //A3
+#define  key_Bb3  46        //A#3/Bb3
+#define  key_B3   47        //B3
+#define  key_C4   48        //C4
+#define  key_Db4  49        //C#4/Db4
+#define  key_D4   50        //D4
+#define  key_Eb4  51        //D#4/Eb4
+#define  key_E4   52        //E4
+#define  key_F4   53        //F4
+#define  key_Gb4  54        //F#4/Gb4
+#define  key_G4   55        //G4
+#define  key_Ab4  56        //G#4/Ab4
+#define  key_A4   57        //A4
+#define  key_Bb4  58        //A#4/Bb4
+#define  key_B4   59        //B4
+#define  key_C5   60        //C5
+#define  key_Db5  61        //C#5/Db5
+#define  key_D5   62        //D5
+#define  key_Eb5  63        //D#5/Eb5
+#define  key_E5   64        //E5
+#define  key_F5   65        //F5
+#define  key_Gb5  66        //F#5/Gb5
+#define  key_G5   67        //G5
+#define  key_Ab5  68        //G#5/Ab5
+#define  key_A5   69        //A5
+#define  key_Bb5  70        //A#5/Bb5
+#define  key_B5   71        //B5
+#define  key_C6   72        //C6
+#define  key_Db6  73        //C#6/Db6
+#define  key_D6   74        //D6
+#define  key_Eb6  75        //D#6/Eb6
+#define  key_E6   76        //E6
+#define  key_F6   77        //F6
+#define  key_Gb6  78        //F#6/Gb6
+#define  key_G6   79        //G6
+#define  key_Ab6  80        //G#6/Ab6
+#define  key_A6   81        //A6
+#define  key_Bb6  82        //A#6/Bb6
+#define  key_B6   83        //B6
+#define  key_C7   84        //C7
+#define  key_Db7  85        //C#7/Db7
+#define  key_D7   86        //D7
+#define  key_Eb7  87        //D#7/Eb7
+#define  key_E7   88        //E7
+#define  key_F7   89        //F7
+#define  key_Gb7  90        //F#7/Gb7
+#define  key_G7   91        //G7
+#define  key_Ab7  92        //G#7/Ab7
+#define  key_A7   93        //A7
+#define  key_Bb7  94        //A#7/Bb7
+#define  key_B7   95        //B7
+#define  key_C8   96        //C8
+#define  key_Db8  97        //C#8/Db8
+#define  key_D8   98        //D8
+#define  key_Eb8  99        //D#8/Eb8
+
 #endif //OTTOSOUNDNOTE_h
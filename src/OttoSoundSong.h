@@ -24,80 +24,59 @@
 #define OTTOSOUNDSONG_h
 
 #include <Arduino.h>
-#include "OttoSoundNote.h"
+#include "OttoSound.h"
+
+//-- Songs in the packed format (see OttoSong in OttoSound.h)
 
 // Silent Night -----------------------------------------------------------------------------
 
-const PROGMEM float Silent_night_lead_notes[] = {
-    note_G4, note_A4, note_G4, note_E4,
-    note_G4, note_A4, note_G4, note_E4,
-    note_D5, note_D5, note_B4,
-    note_C5, note_C5, note_G4,
-    note_A4, note_A4, note_C5, note_B4, note_A4, note_G4, note_A4, note_G4, note_E4,
-    note_A4, note_A4, note_C5, note_B4, note_A4, note_G4, note_A4, note_G4, note_E4,
-    note_D5, note_D5, note_F5, note_D5, note_B4, note_C5, note_E5,
-    note_C5, note_G4, note_E4, note_G4, note_F4, note_D4, note_C4
+const uint8_t silent_night_lead[] PROGMEM = {
+    SONG_T(3), key_G4, SONG_T(1), key_A4, SONG_T(2), key_G4, SONG_T(6), key_E4,
+    SONG_T(3), key_G4, SONG_T(1), key_A4, SONG_T(2), key_G4, SONG_T(6), key_E4,
+    SONG_T(4), key_D5, SONG_T(2), key_D5, SONG_T(6), key_B4,
+    SONG_T(4), key_C5, SONG_T(2), key_C5, SONG_T(6), key_G4,
+    SONG_T(4), key_A4, SONG_T(2), key_A4, SONG_T(3), key_C5, SONG_T(1), key_B4, SONG_T(2), key_A4, SONG_T(3), key_G4, SONG_T(1), key_A4, SONG_T(2), key_G4, SONG_T(6), key_E4,
+    SONG_T(4), key_A4, SONG_T(2), key_A4, SONG_T(3), key_C5, SONG_T(1), key_B4, SONG_T(2), key_A4, SONG_T(3), key_G4, SONG_T(1), key_A4, SONG_T(2), key_G4, SONG_T(6), key_E4,
+    SONG_T(4), key_D5, SONG_T(2), key_D5, SONG_T(3), key_F5, SONG_T(1), key_D5, SONG_T(2), key_B4, SONG_T(6), key_C5, key_E5,
+    SONG_T(2), key_C5, key_G4, key_E4, SONG_T(3), key_G4, SONG_T(1), key_F4, SONG_T(2), key_D4, SONG_T(6), key_C4,
+    SONG_END
 };
 
-const PROGMEM uint16_t Silent_night_lead_duration[] = { //120BPM
-    750, 250, 500, 1500,
-    750, 250, 500, 1500,
-    1000, 500, 1500,
-    1000, 500, 1500,
-    1000, 500, 750, 250, 500, 750, 250, 500, 1500,
-    1000, 500, 750, 250, 500, 750, 250, 500, 1500,
-    1000, 500, 750, 250, 500, 1500, 1500,
-    500, 500, 500, 750, 250, 500, 1500
+const uint8_t silent_night_bass[] PROGMEM = {
+    SONG_T(6), key_C2, key_C2, key_C2, key_C2, key_G1, key_G1, key_C2, key_C2,
+    key_F1, key_F1, key_C2, key_C2, key_F1, key_F1, key_C2, key_C2,
+    key_G1, key_G1, key_C2, key_C2, key_C2, key_G1, key_C2,
+    SONG_END
 };
 
-const PROGMEM float Silent_night_bass_notes[] = {
-    note_C2, note_C2, note_C2, note_C2, note_G1, note_G1, note_C2, note_C2,
-    note_F1, note_F1, note_C2, note_C2, note_F1, note_F1, note_C2, note_C2,
-    note_G1, note_G1, note_C2, note_C2, note_C2, note_G1, note_C2
-};
-
-const PROGMEM uint16_t Silent_night_bass_duration[] = { //120BPM
-    1500, 1500, 1500, 1500, 1500, 1500, 1500, 1500,
-    1500, 1500, 1500, 1500, 1500, 1500, 1500, 1500,
-    1500, 1500, 1500, 1500, 1500, 1500, 1500
-};
+//-- 120BPM, one unit = 1/8 note
+const OttoSong song_silent_night PROGMEM = {250, {silent_night_lead, silent_night_bass}};
 
 // Tetris -----------------------------------------------------------------------------------
 
-const PROGMEM float tetris_lead_notes[] = {
+const uint8_t tetris_lead[] PROGMEM = {
     // part 1
-    note_E5, note_B4, note_C5, note_D5, note_C5, note_B4, note_A4, note_A4, note_C5, note_E5, note_D5, note_C5, note_B4, note_B4, note_C5, note_D5, note_E5, note_C5, note_A4, note_A4, note_R,
-    note_D5, note_F5, note_A5, note_G5, note_F5, note_E5, note_C5, note_E5, note_D5, note_C5, note_B4, note_B4, note_C5, note_D5, note_E5, note_C5, note_A4, note_A4, note_R,
+    SONG_T(2), key_E5, SONG_T(1), key_B4, key_C5, SONG_T(2), key_D5, SONG_T(1), key_C5, key_B4, SONG_T(2), key_A4, SONG_T(1), key_A4, key_C5, SONG_T(2), key_E5, SONG_T(1), key_D5, key_C5, SONG_T(2), key_B4, SONG_T(1), key_B4, key_C5, SONG_T(2), key_D5, key_E5, key_C5, key_A4, key_A4, key_R,
+    SONG_T(3), key_D5, SONG_T(1), key_F5, SONG_T(2), key_A5, SONG_T(1), key_G5, key_F5, SONG_T(3), key_E5, SONG_T(1), key_C5, SONG_T(2), key_E5, SONG_T(1), key_D5, key_C5, SONG_T(2), key_B4, SONG_T(1), key_B4, key_C5, SONG_T(2), key_D5, key_E5, key_C5, key_A4, key_A4, key_R,
     // part 2
-    note_E4, note_C4, note_D4, note_B3, note_C4, note_A3, note_Ab3, note_B3,
-    note_E4, note_C4, note_D4, note_B3, note_C4, note_E4, note_A4, note_A4, note_Ab4, note_R
+    SONG_T(4), key_E4, key_C4, key_D4, key_B3, key_C4, key_A3, key_Ab3, key_B3,
+    key_E4, key_C4, key_D4, key_B3, SONG_T(2), key_C4, key_E4, key_A4, key_A4, SONG_T(6), key_Ab4, SONG_T(2), key_R,
+    SONG_END
 };
 
-const PROGMEM uint16_t tetris_lead_duration[] = { //120BPM
-  // part 1
-  500, 250, 250, 500, 250, 250, 500, 250, 250, 500, 250, 250, 500, 250, 250, 500, 500, 500, 500, 500, 500,
-  750, 250, 500, 250, 250, 750, 250, 500, 250, 250, 500, 250, 250, 500, 500, 500, 500, 500, 500,
-  // part 2
-  1000, 1000, 1000, 1000, 1000, 1000, 1000, 1000,
-  1000, 1000, 1000, 1000, 500, 500, 500, 500, 1500, 500
-};
-
-const PROGMEM float tetris_bass_notes[] = {
+//-- The first note lasts one unit like the others. The original player held
+//-- it 1500 ms, which put the bass 5 units behind the lead for the whole song.
+const uint8_t tetris_bass[] PROGMEM = {
     // part 1
-    note_E2, note_E3, note_E2, note_E3, note_E2, note_E3, note_E2, note_E3, note_A1, note_A2, note_A1, note_A2, note_A1, note_A2, note_A1, note_A2, note_Ab1, note_Ab2, note_Ab1, note_Ab2, note_Ab1, note_Ab2, note_Ab1, note_Ab2, note_A1, note_A2, note_A1, note_A2, note_A1, note_B2, note_C3, note_E3,
-    note_D2, note_D3, note_D2, note_D3, note_D2, note_D3, note_D2, note_D3, note_C2, note_C3, note_C2, note_C3, note_C2, note_C3, note_C2, note_C3, note_B1, note_B2, note_B1, note_B2, note_B1, note_B2, note_B1, note_B2, note_A1, note_A2, note_A1, note_A2, note_A1, note_A2, note_A1, note_A2,
+    SONG_T(1), key_E2, key_E3, key_E2, key_E3, key_E2, key_E3, key_E2, key_E3, key_A1, key_A2, key_A1, key_A2, key_A1, key_A2, key_A1, key_A2, key_Ab1, key_Ab2, key_Ab1, key_Ab2, key_Ab1, key_Ab2, key_Ab1, key_Ab2, key_A1, key_A2, key_A1, key_A2, key_A1, key_B2, key_C3, key_E3,
+    key_D2, key_D3, key_D2, key_D3, key_D2, key_D3, key_D2, key_D3, key_C2, key_C3, key_C2, key_C3, key_C2, key_C3, key_C2, key_C3, key_B1, key_B2, key_B1, key_B2, key_B1, key_B2, key_B1, key_B2, key_A1, key_A2, key_A1, key_A2, key_A1, key_A2, key_A1, key_A2,
     // part 2
-    note_A1, note_E2, note_A1, note_E2, note_A1, note_E2, note_A1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2, note_A1, note_E2, note_A1, note_E2, note_A1, note_E2, note_A1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2,
-    note_A1, note_E2, note_A1, note_E2, note_A1, note_E2, note_A1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2, note_A1, note_E2, note_A1, note_E2, note_A1, note_E2, note_A1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2, note_Ab1, note_E2
+    key_A1, key_E2, key_A1, key_E2, key_A1, key_E2, key_A1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2, key_A1, key_E2, key_A1, key_E2, key_A1, key_E2, key_A1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2,
+    key_A1, key_E2, key_A1, key_E2, key_A1, key_E2, key_A1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2, key_A1, key_E2, key_A1, key_E2, key_A1, key_E2, key_A1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2, key_Ab1, key_E2,
+    SONG_END
 };
 
-const PROGMEM float tetris_bass_duration[] = {
-    // part 1
-    250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250,
-    250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250,
-    // part 2
-    250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250,
-    250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250
-};
+//-- 120BPM, one unit = 1/8 note
+const OttoSong song_tetris PROGMEM = {250, {tetris_lead, tetris_bass}};
 
 #endif //OTTOSOUNDSONG_h
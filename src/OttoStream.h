@@ -0,0 +1,242 @@
+/**
+ * @file OttoStream.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Real-time joint streaming: positions received on a serial port, played on a frame clock
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OTTOSTREAM_h
+#define OTTOSTREAM_h
+
+#include <Arduino.h>
+#include "OttoServo.h"
+
+/** Configuration *************************************************************/
+#define STREAM_FRAME_TIME       20      //-- Frame clock period (ms): 50 Hz
+#define STREAM_BUFFER_SIZE      8       //-- Frames of the jitter buffer (one place kept free)
+#define STREAM_PREFILL          2       //-- Frames buffered before playing, after an underrun
+#define STREAM_LEVEL_MAX        4       //-- Frames buffered above which the oldest are dropped
+#define STREAM_SYNC             0xFF    //-- First byte of a packet (never a position)
+
+/******************************************************************************/
+
+/**
+ * @brief Joint streaming statistics
+ */
+typedef struct {
+    uint32_t frames;        //-- Frames played
+    uint16_t underruns;     //-- Frame ticks with an empty buffer while playing
+    uint16_t overruns;      //-- Frames dropped, more than STREAM_LEVEL_MAX buffered
+    uint16_t errors;        //-- Packets with a bad checksum or position
+} OttoStreamStats;
+
+/**
+ * @brief Plays joint positions streamed from a PC
+ *
+ * A packet is STREAM_SYNC, the position of each joint (0 to 180 degrees)
+ * and a checksum: the sum of the positions modulo 255. update() reads the
+ * available bytes without waiting and puts the complete packets in a jitter
+ * buffer. Once STREAM_PREFILL frames are buffered, one frame is output every
+ * STREAM_FRAME_TIME ms, on a fixed grid: the latency from the PC to the
+ * servos is constant as long as the packets arrive at the frame rate.
+ * When the buffer is empty at a tick (underrun), the last positions are
+ * held and the buffer is filled again; when more than STREAM_LEVEL_MAX
+ * frames are buffered (overrun, the PC clock is faster), the oldest frames
+ * are dropped to keep the latency.
+ *
+ * @tparam N Number of Servo
+ */
+template <uint8_t N>
+class OttoStream
+{
+    private:
+        OttoServo<N> *_servo;
+        Stream *_port;
+        uint8_t _buffer[STREAM_BUFFER_SIZE][N];
+        uint8_t _head;              //-- Next frame to play
+        uint8_t _tail;              //-- Next free frame
+        uint8_t _packet[N + 1];     //-- Packet being received (positions, checksum)
+        uint8_t _received;          //-- Bytes of the packet received, 0xFF: wait for a sync
+        bool _playing;
+        bool _active;
+        uint32_t _nextFrame;        //-- Time of the next frame (ms)
+        OttoStreamStats _stats;
+
+        void _receive(uint8_t c);
+        uint8_t _level() {return (_tail - _head + STREAM_BUFFER_SIZE) % STREAM_BUFFER_SIZE;};
+
+    public:
+        OttoStream(OttoServo<N> &servo, Stream &port);
+        void begin();
+        void end();
+        bool update();
+        bool isPlaying() {return _playing;};
+        uint8_t getLevel() {return _level();};
+        const OttoStreamStats &getStats() {return _stats;};
+        void resetStats();
+};
+
+/**
+ * @brief Construct a new joint stream
+ *
+ * @tparam N Number of Servo
+ * @param servo Servos driven by the stream (Otto, OttoLee...)
+ * @param port  Serial port of the packets
+ */
+template <uint8_t N>
+OttoStream<N>::OttoStream(OttoServo<N> &servo, Stream &port)
+{
+    _servo = &servo;
+    _port = &port;
+    _active = false;
+    _playing = false;
+    resetStats();
+}
+
+/**
+ * @brief Start streaming: the current motion is stopped and the buffer emptied
+ *
+ * @tparam N Number of Servo
+ */
+template <uint8_t N>
+void OttoStream<N>::begin()
+{
+    _servo->stopMotion();
+    _head = 0;
+    _tail = 0;
+    _received = 0xFF;
+    _playing = false;
+    _active = true;
+}
+
+/**
+ * @brief Stop streaming, the servos keep the last positions
+ *
+ * @tparam N Number of Servo
+ */
+template <uint8_t N>
+void OttoStream<N>::end()
+{
+    _active = false;
+    _playing = false;
+    _servo->setStreamFrame(false);
+}
+
+/**
+ * @brief Clear the statistics
+ *
+ * @tparam N Number of Servo
+ */
+template <uint8_t N>
+void OttoStream<N>::resetStats()
+{
+    _stats.frames = 0;
+    _stats.underruns = 0;
+    _stats.overruns = 0;
+    _stats.errors = 0;
+}
+
+/**
+ * @brief Receive the packets and play the frame due. Must be called from
+ * loop(), more often than STREAM_FRAME_TIME.
+ *
+ * @tparam N Number of Servo
+ * @return true     A frame was output
+ */
+template <uint8_t N>
+bool OttoStream<N>::update()
+{
+    if (!_active) return false;
+
+    int16_t count = _port->available();
+    while (count-- > 0) _receive(_port->read());
+
+    if (!_playing) {
+        if (_level() < STREAM_PREFILL) return false;
+        //-- The grid starts with the first frame
+        _playing = true;
+        _nextFrame = millis();
+    }
+
+    uint32_t now = millis();
+    if ((int32_t)(now - _nextFrame) < 0) return false;
+    //-- Keep the grid; a late call skips the ticks missed
+    _nextFrame += STREAM_FRAME_TIME * (1 + (now - _nextFrame) / STREAM_FRAME_TIME);
+
+    if (_head == _tail) {
+        //-- Hold the last positions and buffer again
+        if (_stats.underruns < 0xFFFF) _stats.underruns++;
+        _playing = false;
+        _servo->setStreamFrame(false);
+        return false;
+    }
+    while (_level() > STREAM_LEVEL_MAX) {
+        _head = (_head + 1) % STREAM_BUFFER_SIZE;
+        if (_stats.overruns < 0xFFFF) _stats.overruns++;
+    }
+    //-- The scheduler keeps the next tick free
+    _servo->setStreamFrame(true, _nextFrame);
+    _servo->writeServos(_buffer[_head]);
+    _head = (_head + 1) % STREAM_BUFFER_SIZE;
+    _stats.frames++;
+    return true;
+}
+
+/**
+ * @brief Add a received byte to the packet, queue the packet when complete
+ *
+ * @tparam N Number of Servo
+ * @param c Received byte
+ */
+template <uint8_t N>
+void OttoStream<N>::_receive(uint8_t c)
+{
+    if (c == STREAM_SYNC) {
+        //-- A sync byte always starts a packet: a cut packet is lost
+        if ((_received != 0xFF) && (_received > 0) && (_stats.errors < 0xFFFF)) _stats.errors++;
+        _received = 0;
+        return;
+    }
+    if (_received == 0xFF) return;
+
+    _packet[_received++] = c;
+    if (_received < N + 1) {
+        if (c <= 180) return;
+        //-- Not a position: wait for the next sync
+    }
+    else {
+        uint16_t sum = 0;
+        for (uint8_t i = 0; i < N; i++) sum += _packet[i];
+        if ((sum % 255) == c) {
+            uint8_t next = (_tail + 1) % STREAM_BUFFER_SIZE;
+            if (next == _head) {
+                //-- Full: drop the oldest frame to keep the latency
+                _head = (_head + 1) % STREAM_BUFFER_SIZE;
+                if (_stats.overruns < 0xFFFF) _stats.overruns++;
+            }
+            memcpy(_buffer[_tail], _packet, N);
+            _tail = next;
+            _received = 0xFF;
+            return;
+        }
+    }
+    if (_stats.errors < 0xFFFF) _stats.errors++;
+    _received = 0xFF;
+}
+
+#endif //OTTOSTREAM_h
@@ -0,0 +1,140 @@
+/**
+ * @file OttoTelemetry.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Telemetry: RAM ring buffer of the last frames and binary dump
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include "OttoTelemetry.h"
+
+#ifdef __USE_TELEMETRY
+
+OttoTelemetryRecord OttoTelemetry::_records[TELEMETRY_RECORDS];
+uint8_t OttoTelemetry::_head = 0;
+uint8_t OttoTelemetry::_count = 0;
+uint8_t OttoTelemetry::_decimation = TELEMETRY_DECIMATION;
+uint8_t OttoTelemetry::_skip = 0;
+uint16_t OttoTelemetry::_distance = 0xFFFF;
+uint16_t OttoTelemetry::_noise = 0;
+
+/**
+ * @brief Record a servo frame, one in the decimation
+ *
+ * @param joint     Joint positions (degrees)
+ * @param count     Number of joints
+ * @param motion    Motion type (MOTION_xxx)
+ * @param gait      Gait of the oscillation (GAIT_xxx)
+ */
+void OttoTelemetry::logFrame(const uint8_t *joint, uint8_t count, uint8_t motion, uint8_t gait)
+{
+    if (_skip > 0) {
+        _skip--;
+        return;
+    }
+    _skip = _decimation - 1;
+
+    OttoTelemetryRecord *record = &_records[_head];
+    record->time = millis();
+    for (uint8_t i = 0; i < TELEMETRY_JOINTS; i++) record->joint[i] = (i < count) ? joint[i] : 0xFF;
+    record->motion = motion;
+    record->gait = gait;
+    record->distance = _distance;
+    record->noise = _noise;
+
+    _head = (_head + 1) % TELEMETRY_RECORDS;
+    if (_count < TELEMETRY_RECORDS) _count++;
+}
+
+/**
+ * @brief Record one servo frame in decimation
+ *
+ * @param decimation 1 = every frame
+ */
+void OttoTelemetry::setDecimation(uint8_t decimation)
+{
+    _decimation = (decimation > 0) ? decimation : 1;
+    _skip = 0;
+}
+
+/**
+ * @brief Forget the records
+ */
+void OttoTelemetry::clear()
+{
+    _head = 0;
+    _count = 0;
+    _skip = 0;
+}
+
+/**
+ * @brief Write the records in binary (see OttoTelemetry.h for the format)
+ *
+ * @param port Serial port
+ */
+void OttoTelemetry::dump(Print &port)
+{
+    uint8_t sum = 0;
+    uint8_t index = (_head + TELEMETRY_RECORDS - _count) % TELEMETRY_RECORDS;
+
+    _write(port, 'O', 1, &sum);
+    _write(port, 'T', 1, &sum);
+    _write(port, TELEMETRY_VERSION, 1, &sum);
+    _write(port, TELEMETRY_JOINTS, 1, &sum);
+    _write(port, _count, 1, &sum);
+
+    for (uint8_t n = 0; n < _count; n++) {
+        const OttoTelemetryRecord *record = &_records[index];
+        _write(port, record->time, 4, &sum);
+        for (uint8_t i = 0; i < TELEMETRY_JOINTS; i++) _write(port, record->joint[i], 1, &sum);
+        _write(port, record->motion, 1, &sum);
+        _write(port, record->gait, 1, &sum);
+        _write(port, record->distance, 2, &sum);
+        _write(port, record->noise, 2, &sum);
+        index = (index + 1) % TELEMETRY_RECORDS;
+    }
+    port.write(sum);
+}
+
+/**
+ * @brief Dump the records when TELEMETRY_CMD_DUMP is received. The other
+ * bytes are left in the port for the sketch.
+ *
+ * @param port      Serial port
+ * @return true     The records were dumped
+ */
+bool OttoTelemetry::poll(Stream &port)
+{
+    if (port.peek() != TELEMETRY_CMD_DUMP) return false;
+    port.read();
+    dump(port);
+    return true;
+}
+
+//-- Write a value LSB first and add its bytes to the checksum
+void OttoTelemetry::_write(Print &port, uint32_t value, uint8_t size, uint8_t *sum)
+{
+    while (size--) {
+        uint8_t b = value & 0xFF;
+        port.write(b);
+        *sum += b;
+        value >>= 8;
+    }
+}
+
+#endif //__USE_TELEMETRY
@@ -0,0 +1,91 @@
+/**
+ * @file OttoTelemetry.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Telemetry: RAM ring buffer of the last frames and binary dump
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OTTOTELEMETRY_h
+#define OTTOTELEMETRY_h
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/** Configuration *************************************************************/
+//-- Uncomment to record the servo frames and the sensors in RAM
+//-- (TELEMETRY_RECORDS * 17 bytes)
+// #define __USE_TELEMETRY     1
+
+#define TELEMETRY_RECORDS       16      //-- Records kept (the oldest are overwritten)
+#define TELEMETRY_JOINTS        7       //-- Joints per record (Otto Lee)
+#define TELEMETRY_DECIMATION    3       //-- Default: one record every n servo frames
+#define TELEMETRY_CMD_DUMP      'T'     //-- Serial command of poll(): dump the records
+#define TELEMETRY_VERSION       1       //-- Format of the dump
+
+/******************************************************************************/
+
+/**
+ * @brief One record: state of Otto at a servo frame
+ */
+typedef struct {
+    uint32_t time;                      //-- millis() of the frame
+    uint8_t joint[TELEMETRY_JOINTS];    //-- Joint positions (degrees), 0xFF = no joint
+    uint8_t motion;                     //-- Motion type (MOTION_xxx)
+    uint8_t gait;                       //-- Gait of the oscillation (GAIT_xxx)
+    uint16_t distance;                  //-- Last ping (mm), DISTANCE_NONE = no echo
+    uint16_t noise;                     //-- Noise level (0 without __USE_NOISE_ADC)
+} OttoTelemetryRecord;
+
+/**
+ * @brief Ring buffer of the last servo frames, one in TELEMETRY_DECIMATION
+ *
+ * OttoServo logs the frames it outputs and OttoSensor the last ping and
+ * noise level, which are added to the next record. The raw ping is kept,
+ * so that the distance filter can be replayed offline. Logging a record is
+ * a copy of a few bytes; the frames in between only decrement a counter.
+ *
+ * dump() writes, little endian:
+ *   'O' 'T' version joints count
+ *   count records, the oldest first:
+ *       time (4) joints (joints) motion (1) gait (1) distance (2) noise (2)
+ *   checksum: sum of the previous bytes modulo 256
+ */
+class OttoTelemetry
+{
+public:
+    static void logFrame(const uint8_t *joint, uint8_t count, uint8_t motion, uint8_t gait);
+    static void logDistance(uint16_t mm) {_distance = mm;};
+    static void logNoise(uint16_t noise) {_noise = noise;};
+    static void setDecimation(uint8_t decimation);
+    static uint8_t getCount() {return _count;};
+    static void clear();
+    static void dump(Print &port);
+    static bool poll(Stream &port);
+
+private:
+    static OttoTelemetryRecord _records[TELEMETRY_RECORDS];
+    static uint8_t _head;           //-- Next record to write
+    static uint8_t _count;
+    static uint8_t _decimation;
+    static uint8_t _skip;           //-- Frames to skip before the next record
+    static uint16_t _distance;
+    static uint16_t _noise;
+    static void _write(Print &port, uint32_t value, uint8_t size, uint8_t *sum);
+};
+
+#endif //OTTOTELEMETRY_h
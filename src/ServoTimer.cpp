@@ -0,0 +1,228 @@
+/**
+ * @file ServoTimer.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include "ServoTimer.h"
+
+#ifdef __USE_SERVO_TIMER
+
+//-- The pulses are output by the Timer1 interrupt, which only exists on AVR
+#if !defined(__AVR__)
+  #error "__USE_SERVO_TIMER needs an AVR board (Timer1): use the Arduino Servo library on this board"
+#endif
+
+#define _TICKS_PER_US     (F_CPU / 8000000UL) //-- Timer1 prescaler = 8
+
+#define _FRAME_TICKS      ((uint16_t)(SERVO_TIMER_FRAME * _TICKS_PER_US))
+#define _MARGIN_TICKS     ((uint16_t)(8 * _TICKS_PER_US))   //-- Pulses closer than this end together
+//-- (MAX_PULSE - MIN_PULSE) / 180 in 1/256 us
+#define _US_PER_DEGREE    (((SERVO_TIMER_MAX_PULSE - SERVO_TIMER_MIN_PULSE) * 256UL) / 180)
+
+/**
+ * @brief One entry of the pulse table: pins of a port ending at the same time
+ */
+typedef struct {
+    uint16_t ticks;             //-- End of the pulse (timer ticks from the frame start)
+    volatile uint8_t *port;     //-- Output register of the pins
+    uint8_t mask;               //-- Pins of the port
+} ServoPulse;
+
+//-- Channels
+static uint8_t _channelUsed;                                    //-- One bit per channel
+static volatile uint8_t *_channelPort[SERVO_TIMER_MAX_CHANNELS];
+static uint8_t _channelMask[SERVO_TIMER_MAX_CHANNELS];
+static uint16_t _channelUs[SERVO_TIMER_MAX_CHANNELS];           //-- Staged pulse width
+static uint16_t _outputUs[SERVO_TIMER_MAX_CHANNELS];            //-- Committed pulse width
+
+//-- Double buffered pulse table, sorted by increasing width
+static ServoPulse _pulseTable[2][SERVO_TIMER_MAX_CHANNELS];
+static uint8_t _pulseCount[2];
+static volatile uint8_t _front;         //-- Table output by the interrupt
+static volatile bool _pending;          //-- The back table must be used from the next frame
+static uint8_t _next;                   //-- Next pulse to end in the front table
+static bool _timerStarted;
+
+/**
+ * @brief Start Timer1 in normal mode, 0.5us tick (16MHz)
+ *
+ */
+static void _startTimer()
+{
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11);
+    TCNT1 = 0;
+    OCR1A = _FRAME_TICKS;
+    TIFR1 |= _BV(OCF1A);
+    TIMSK1 |= _BV(OCIE1A);
+    _timerStarted = true;
+}
+
+ISR(TIMER1_COMPA_vect)
+{
+    ServoTimer::handleInterrupt();
+}
+
+/**
+ * @brief Attach a pin to a free channel
+ *
+ * @param pin   Servo pin
+ * @return uint8_t Channel number, SERVO_TIMER_INVALID if no channel is free
+ */
+uint8_t ServoTimer::attach(uint8_t pin)
+{
+    uint8_t channel;
+
+    for (channel = 0; channel < SERVO_TIMER_MAX_CHANNELS; channel++) {
+        if (!(_channelUsed & (1 << channel))) break;
+    }
+    if (channel >= SERVO_TIMER_MAX_CHANNELS) return SERVO_TIMER_INVALID;
+
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, LOW);
+    _channelPort[channel] = portOutputRegister(digitalPinToPort(pin));
+    _channelMask[channel] = digitalPinToBitMask(pin);
+    _channelUs[channel] = (SERVO_TIMER_MIN_PULSE + SERVO_TIMER_MAX_PULSE) / 2;
+    _channelUsed |= (1 << channel);
+
+    if (!_timerStarted) _startTimer();
+
+    return channel;
+}
+
+/**
+ * @brief Release a channel. The pulse stops from the next frame.
+ *
+ * @param channel
+ */
+void ServoTimer::detach(uint8_t channel)
+{
+    if (!attached(channel)) return;
+    _channelUsed &= ~(1 << channel);
+    commit();
+}
+
+/**
+ * @brief Check if a channel is in use
+ *
+ * @param channel
+ */
+bool ServoTimer::attached(uint8_t channel)
+{
+    if (channel >= SERVO_TIMER_MAX_CHANNELS) return false;
+    return (_channelUsed & (1 << channel)) != 0;
+}
+
+/**
+ * @brief Stage the position of a channel. It is output after commit().
+ *
+ * @param channel
+ * @param angle     Position (0 to 180 degrees)
+ */
+void ServoTimer::write(uint8_t channel, int16_t angle)
+{
+    if (channel >= SERVO_TIMER_MAX_CHANNELS) return;
+    if (angle < 0) angle = 0;
+    if (angle > 180) angle = 180;
+    _channelUs[channel] = SERVO_TIMER_MIN_PULSE + (uint16_t)(((uint32_t)angle * _US_PER_DEGREE) >> 8);
+}
+
+/**
+ * @brief Publish the staged positions of all the channels.
+ * The new pulse table is used from the start of the next frame.
+ *
+ */
+void ServoTimer::commit()
+{
+    //-- Stop any pending swap while the back table is rebuilt
+    noInterrupts();
+    _pending = false;
+    interrupts();
+
+    uint8_t back = _front ^ 1;
+    ServoPulse *table = _pulseTable[back];
+    uint8_t count = 0;
+
+    for (uint8_t channel = 0; channel < SERVO_TIMER_MAX_CHANNELS; channel++) {
+        if (!(_channelUsed & (1 << channel))) continue;
+        _outputUs[channel] = _channelUs[channel];
+        uint16_t ticks = _channelUs[channel] * _TICKS_PER_US;
+
+        //-- Insertion sort, pins of the same port ending together share an entry
+        uint8_t i = count;
+        while (i > 0 && table[i - 1].ticks > ticks) i--;
+        if (i > 0 && table[i - 1].ticks == ticks && table[i - 1].port == _channelPort[channel]) {
+            table[i - 1].mask |= _channelMask[channel];
+            continue;
+        }
+        for (uint8_t j = count; j > i; j--) table[j] = table[j - 1];
+        table[i].ticks = ticks;
+        table[i].port = _channelPort[channel];
+        table[i].mask = _channelMask[channel];
+        count++;
+    }
+    _pulseCount[back] = count;
+
+    _pending = true;
+}
+
+/**
+ * @brief Committed pulse width of a channel
+ *
+ * @param channel
+ * @return uint16_t Pulse width (us), 0 if the channel is not attached
+ */
+uint16_t ServoTimer::readMicroseconds(uint8_t channel)
+{
+    if (!attached(channel)) return 0;
+    return _outputUs[channel];
+}
+
+/**
+ * @brief Timer compare interrupt: start a frame or end the due pulses
+ *
+ */
+void ServoTimer::handleInterrupt()
+{
+    const ServoPulse *table = _pulseTable[_front];
+
+    if (_next >= _pulseCount[_front]) {
+        //-- Start of a new frame, switch to the last committed table
+        TCNT1 = 0;
+        if (_pending) {
+            _front ^= 1;
+            _pending = false;
+            table = _pulseTable[_front];
+        }
+        _next = 0;
+        //-- All the pulses start together
+        for (uint8_t i = 0; i < _pulseCount[_front]; i++) *table[i].port |= table[i].mask;
+    } else {
+        //-- End all the pulses due now
+        while ((_next < _pulseCount[_front]) && (table[_next].ticks <= (uint16_t)(TCNT1 + _MARGIN_TICKS))) {
+            *table[_next].port &= ~table[_next].mask;
+            _next++;
+        }
+    }
+
+    OCR1A = (_next < _pulseCount[_front]) ? table[_next].ticks : _FRAME_TICKS;
+}
+
+#endif //__USE_SERVO_TIMER
@@ -0,0 +1,61 @@
+/**
+ * @file ServoTimer.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Single timer multi-channel servo pulse generator
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVOTIMER_h
+#define SERVOTIMER_h
+
+#include <stdint.h>
+
+/** Configuration *************************************************************/
+//-- Uncomment to drive the servos with ServoTimer instead of the Arduino Servo
+//-- library. Both use Timer1 and cannot be linked in the same sketch (AVR only).
+// #define __USE_SERVO_TIMER   1
+
+#define SERVO_TIMER_MAX_CHANNELS    8
+#define SERVO_TIMER_FRAME           20000   //-- Frame period (us)
+#define SERVO_TIMER_MIN_PULSE       544     //-- Pulse at 0 degree (us)
+#define SERVO_TIMER_MAX_PULSE       2400    //-- Pulse at 180 degrees (us)
+#define SERVO_TIMER_INVALID         0xFF
+
+/******************************************************************************/
+
+/**
+ * @brief Servo pulse generator using one hardware timer for all the channels
+ *
+ * All the pulses of a frame start together and the timer interrupt ends them
+ * in increasing width order, from a table sorted once per frame by commit().
+ * Positions written with write() are staged and only output once commit()
+ * is called, so all the joints of a frame change at the same time.
+ */
+class ServoTimer
+{
+public:
+    static uint8_t attach(uint8_t pin);
+    static void detach(uint8_t channel);
+    static bool attached(uint8_t channel);
+    static void write(uint8_t channel, int16_t angle);
+    static void commit();
+    static uint16_t readMicroseconds(uint8_t channel);
+    static void handleInterrupt();
+};
+
+#endif //SERVOTIMER_h
@@ -0,0 +1,479 @@
+/**
+ * @file ToneTimer.cpp
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Timer driven tone generator with note queues and voice mixing
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include "ToneTimer.h"
+#include "OttoSoundNote.h"
+
+#ifdef __USE_TONE_TIMER
+
+#define _TICKS_PER_MS   (TONE_TIMER_RATE / 1000)
+#define _QUEUE_MASK     (TONE_QUEUE_SIZE - 1)
+
+//-- Duty of the square wave for the volumes 1 to 10 (1/65536 period),
+//-- at least one sample per period (see _sampleDuty)
+static const uint16_t _volumeDuty[10] PROGMEM = {257, 328, 437, 524, 655, 753, 1311, 1986, 2979, 32768};
+
+//-- Phase increment of the notes of the 8th octave (C8 to B8), computed at
+//-- compile time. The lower octaves are obtained by shifting.
+#define _KEY_INC(f0)    ((uint16_t)((f0) * 256.0 * 65536.0 / TONE_TIMER_RATE + 0.5))
+static const uint16_t _keyInc[12] PROGMEM = {
+    _KEY_INC(note_C0), _KEY_INC(note_Db0), _KEY_INC(note_D0), _KEY_INC(note_Eb0),
+    _KEY_INC(note_E0), _KEY_INC(note_F0), _KEY_INC(note_Gb0), _KEY_INC(note_G0),
+    _KEY_INC(note_Ab0), _KEY_INC(note_A0), _KEY_INC(note_Bb0), _KEY_INC(note_B0)
+};
+
+/**
+ * @brief Duty of a voice, at least one sample per period: a shorter pulse
+ * would only be caught on some periods (a sub-harmonic, not a quieter note)
+ *
+ * @param duty  Duty of the note (1/65536 period), 0 = silence
+ * @param inc   Phase increment of the voice
+ */
+static inline uint16_t _sampleDuty(uint16_t duty, uint16_t inc)
+{
+    return (duty && (duty < inc)) ? inc : duty;
+}
+
+/**
+ * @brief One voice: note queue, filled by play() and emptied by the interrupt
+ */
+typedef struct {
+    ToneEvent queue[TONE_QUEUE_SIZE];
+    volatile uint8_t head;              //-- Next note to play
+    volatile uint8_t tail;              //-- Next free place
+    ToneEvent current;                  //-- Note being played, time = ms left
+    bool playing;
+    uint16_t inc;                       //-- Phase increment of the output
+    uint16_t duty;                      //-- Duty of the output, 0 = silence
+    uint32_t level;                     //-- Phase increment during a sweep (1/256)
+    uint16_t gate;                      //-- ms left in the gate phase
+    bool gateOff;                       //-- Silent phase of the gate
+#if defined(__AVR__)
+    uint16_t phase;                     //-- Phase of the square wave (1/65536 turn)
+#endif
+} ToneVoice;
+
+static ToneVoice _voice[TONE_VOICES];
+static uint8_t _pin;
+#if defined(__AVR__)
+static volatile uint8_t *_port;         //-- Output register of the buzzer pin
+static uint8_t _mask;
+static uint8_t _tick;                   //-- Samples left in the current ms
+static uint8_t _sounding;               //-- Voices playing a note (not a silence)
+static uint8_t _mix;                    //-- Sigma-delta accumulator
+#else
+static uint32_t _lastMs;                //-- Last ms played (millis)
+static uint16_t _frequency;             //-- Output frequency (Hz)
+#endif
+
+volatile bool ToneTimer::_playing;
+
+/**
+ * @brief Start the next note of the queue of a voice
+ *
+ * @return true     A note is available
+ */
+static bool _nextNote(ToneVoice *voice)
+{
+    while (voice->head != voice->tail) {
+        voice->current = voice->queue[voice->head];
+        voice->head = (voice->head + 1) & _QUEUE_MASK;
+        if (voice->current.time > 0) {
+            voice->inc = voice->current.inc;
+            voice->duty = _sampleDuty(voice->current.duty, voice->inc);
+            voice->level = (uint32_t)voice->current.inc << 8;
+            voice->gate = voice->current.on;
+            voice->gateOff = false;
+            return true;
+        }
+    }
+    voice->inc = 0;
+    voice->duty = 0;
+    voice->playing = false;
+    return false;
+}
+
+/**
+ * @brief One ms of a voice: sweep, gate and end of the note
+ *
+ * @return true     The voice starts or stops sounding
+ */
+static bool _voiceTick(ToneVoice *voice)
+{
+    bool changed = false;
+
+    if (!voice->playing) return false;
+
+    if (voice->current.sweep) {
+        voice->level += ((int32_t)(voice->level >> 8) * voice->current.sweep + 0x800) >> 12;
+        if (voice->level > ((uint32_t)(TONE_TIMER_RATE / 2) << 8)) voice->level = (uint32_t)(TONE_TIMER_RATE / 2) << 8;
+        voice->inc = voice->level >> 8;
+        if (voice->duty) voice->duty = _sampleDuty(voice->current.duty, voice->inc);
+    }
+
+    if (voice->current.off && (--voice->gate == 0)) {
+        voice->gateOff = !voice->gateOff;
+        voice->gate = voice->gateOff ? voice->current.off : voice->current.on;
+        voice->duty = voice->gateOff ? 0 : _sampleDuty(voice->current.duty, voice->inc);
+        changed = true;
+    }
+
+    //-- End of the note: the phase goes on, so notes are joined without click
+    if (--voice->current.time == 0) {
+        _nextNote(voice);
+        changed = true;
+    }
+    return changed;
+}
+
+#if defined(__AVR__)
+/**
+ * @brief Count the voices playing a note, the sigma-delta restarts
+ *
+ */
+static void _countSounding()
+{
+    _sounding = 0;
+    for (uint8_t v = 0; v < TONE_VOICES; v++) {
+        if (_voice[v].inc && _voice[v].duty) _sounding++;
+    }
+    _mix = 0;
+}
+
+/**
+ * @brief Start Timer2 in CTC mode at TONE_TIMER_RATE, 0.5us tick (16MHz)
+ *
+ */
+static void _startTimer()
+{
+    TCCR2A = _BV(WGM21);
+    TCCR2B = _BV(CS21);
+    OCR2A = (F_CPU / 8 / TONE_TIMER_RATE) - 1;
+    TCNT2 = 0;
+    TIFR2 = _BV(OCF2A);
+    TIMSK2 = _BV(OCIE2A);
+}
+
+/**
+ * @brief Stop the timer interrupt and release the buzzer
+ *
+ */
+static void _stopTimer()
+{
+    TIMSK2 &= ~_BV(OCIE2A);
+    *_port &= ~_mask;
+}
+
+ISR(TIMER2_COMPA_vect)
+{
+    ToneTimer::handleInterrupt();
+}
+#else
+/**
+ * @brief Output the first voice playing a note with tone()
+ *
+ */
+static void _outputNote()
+{
+    uint16_t frequency = 0;
+
+    for (uint8_t v = 0; v < TONE_VOICES; v++) {
+        if (_voice[v].inc && _voice[v].duty) {
+            frequency = ((uint32_t)_voice[v].inc * TONE_TIMER_RATE + 0x8000) >> 16;
+            break;
+        }
+    }
+    if (frequency == _frequency) return;
+    _frequency = frequency;
+    if (frequency) tone(_pin, frequency);
+    else noTone(_pin);
+}
+#endif
+
+/**
+ * @brief Phase increment of a note: no division, the increment of the 8th
+ * octave comes from a table and is shifted
+ *
+ * @param key   Key number of the note (see OttoSoundNote.h)
+ * @return uint16_t Phase increment, 0 for a rest
+ */
+static uint16_t _keyToInc(uint8_t key)
+{
+    uint8_t octave = key / 12;
+    if (octave > 8) return 0;
+
+    uint8_t shift = 8 - octave;
+    uint16_t inc = pgm_read_word(&_keyInc[key % 12]);
+    return shift ? ((inc >> (shift - 1)) + 1) >> 1 : inc;
+}
+
+/**
+ * @brief Duty of the square wave for a volume
+ *
+ * @param volume    Volume (1 to 10), 0 = silence
+ */
+static uint16_t _volumeToDuty(uint8_t volume)
+{
+    if (volume == 0) return 0;
+    return pgm_read_word(&_volumeDuty[min(volume, 10) - 1]);
+}
+
+/**
+ * @brief Select the buzzer pin (the pin must be an output)
+ *
+ * @param pin   Buzzer pin
+ */
+void ToneTimer::begin(uint8_t pin)
+{
+    _pin = pin;
+#if defined(__AVR__)
+    _port = portOutputRegister(digitalPinToPort(pin));
+    _mask = digitalPinToBitMask(pin);
+#endif
+}
+
+/**
+ * @brief Add a note to the queue of a voice. Only waits when the queue is full.
+ *
+ * @param frequency Frequency (Hz), 0 = silence
+ * @param time      Duration (ms)
+ * @param volume    Volume (1 to 10), 0 = silence
+ * @param voice     Voice (0 to TONE_VOICES - 1)
+ */
+void ToneTimer::play(uint16_t frequency, uint16_t time, uint8_t volume, uint8_t voice)
+{
+    ToneEvent note = {0, 0, time, 0, 0, 0};
+
+    if (frequency > TONE_TIMER_RATE / 2) frequency = TONE_TIMER_RATE / 2;
+    note.inc = (((uint32_t)frequency << 16) + TONE_TIMER_RATE / 2) / TONE_TIMER_RATE;
+    _push(&note, volume, voice);
+}
+
+/**
+ * @brief Add a note to the queue of a voice, by key number: no division,
+ * the phase increment comes from a table.
+ *
+ * @param key       Key number of the note (see OttoSoundNote.h), key_R = silence
+ * @param time      Duration (ms)
+ * @param volume    Volume (1 to 10), 0 = silence
+ * @param voice     Voice (0 to TONE_VOICES - 1)
+ */
+void ToneTimer::playKey(uint8_t key, uint16_t time, uint8_t volume, uint8_t voice)
+{
+    ToneEvent note = {_keyToInc(key), 0, time, 0, 0, 0};
+
+    _push(&note, volume, voice);
+}
+
+/**
+ * @brief Add a note repeated with a silence after each repeat: a single
+ * gated note in the queue, whatever the number of repeats.
+ *
+ * @param key       Key number of the note (see OttoSoundNote.h), key_R = silence
+ * @param on        Sound of each repeat (ms)
+ * @param off       Silence after each repeat (ms)
+ * @param count     Number of repeats (count * (on + off) is 65535 ms at most)
+ * @param volume    Volume (1 to 10), 0 = silence
+ * @param voice     Voice (0 to TONE_VOICES - 1)
+ */
+void ToneTimer::repeatKey(uint8_t key, uint16_t on, uint16_t off, uint16_t count, uint8_t volume, uint8_t voice)
+{
+    uint32_t time = (uint32_t)count * (on + off);
+    ToneEvent note = {_keyToInc(key), 0, (uint16_t)min(time, 0xFFFFUL), 0, on, off};
+
+    if (on == 0) note.inc = 0;
+    if (note.inc == 0) note.off = 0;
+    _push(&note, volume, voice);
+}
+
+/**
+ * @brief Add an exponential frequency sweep to the queue of a voice.
+ * The whole sweep is one note: the frequency glides in the generator.
+ *
+ * @param from      Start frequency (Hz)
+ * @param to        End frequency (Hz)
+ * @param time      Duration (ms)
+ * @param volume    Volume (1 to 10), 0 = silence
+ * @param on        Gate: sound during on ms...
+ * @param off       ...then silence during off ms (0 = continuous sound)
+ * @param voice     Voice (0 to TONE_VOICES - 1)
+ */
+void ToneTimer::sweep(uint16_t from, uint16_t to, uint16_t time, uint8_t volume, uint16_t on, uint16_t off, uint8_t voice)
+{
+    ToneEvent note = {0, 0, time, 0, on, off};
+
+    if (from == 0 || to == 0 || time == 0) return;
+    if (from > TONE_TIMER_RATE / 2) from = TONE_TIMER_RATE / 2;
+    if (to > TONE_TIMER_RATE / 2) to = TONE_TIMER_RATE / 2;
+    note.inc = (((uint32_t)from << 16) + TONE_TIMER_RATE / 2) / TONE_TIMER_RATE;
+
+    //-- Increment ratio per ms: exp(k) - 1 with k = ln(to / from) / time
+    if (to != from) {
+        float k = log((float)to / from) / time;
+        float sweep = (k + k * k / 2) * 1048576;
+        note.sweep = constrain(sweep, -32767, 32767);
+    }
+    if (on == 0) note.off = 0;
+
+    _push(&note, volume, voice);
+}
+
+/**
+ * @brief Add a note to the queue of a voice, start the voice if needed
+ *
+ * @param note      Note, duty not set
+ * @param volume    Volume (1 to 10), 0 = silence
+ * @param voice     Voice (0 to TONE_VOICES - 1)
+ */
+void ToneTimer::_push(ToneEvent *note, uint8_t volume, uint8_t voice)
+{
+    if (note->time == 0 || voice >= TONE_VOICES) return;
+    note->duty = (note->inc) ? _volumeToDuty(volume) : 0;
+    if (note->duty == 0) note->inc = 0;
+
+    while (queueFree(voice) == 0) update();
+
+    ToneVoice *v = &_voice[voice];
+    v->queue[v->tail] = *note;
+    noInterrupts();
+    v->tail = (v->tail + 1) & _QUEUE_MASK;
+    if (!v->playing) {
+        v->playing = _nextNote(v);
+#if defined(__AVR__)
+        v->phase = 0;
+        _countSounding();
+        if (!_playing) {
+            _tick = _TICKS_PER_MS;
+            _startTimer();
+        }
+#else
+        if (!_playing) _lastMs = millis();
+        _outputNote();
+#endif
+        _playing = true;
+    }
+    interrupts();
+}
+
+/**
+ * @brief Stop the current notes and clear the queues
+ *
+ */
+void ToneTimer::stop()
+{
+    noInterrupts();
+    for (uint8_t v = 0; v < TONE_VOICES; v++) {
+        _voice[v].head = _voice[v].tail;
+        _voice[v].inc = 0;
+        _voice[v].duty = 0;
+        _voice[v].playing = false;
+    }
+    if (_playing) {
+        _playing = false;
+#if defined(__AVR__)
+        _stopTimer();
+#else
+        _outputNote();
+#endif
+    }
+    interrupts();
+}
+
+/**
+ * @brief Number of notes that can be added to a voice without waiting
+ *
+ * @param voice     Voice (0 to TONE_VOICES - 1)
+ */
+uint8_t ToneTimer::queueFree(uint8_t voice)
+{
+    if (voice >= TONE_VOICES) return 0;
+    return _QUEUE_MASK - ((_voice[voice].tail - _voice[voice].head) & _QUEUE_MASK);
+}
+
+/**
+ * @brief Follow the queues without the hardware timer (not AVR).
+ * To call periodically from the main loop, does nothing on AVR.
+ *
+ */
+void ToneTimer::update()
+{
+#if !defined(__AVR__)
+    if (!_playing) return;
+
+    //-- Play the ms elapsed since the last call
+    uint32_t now = millis();
+    while (_playing && (now != _lastMs)) {
+        _lastMs++;
+        bool playing = false;
+        for (uint8_t v = 0; v < TONE_VOICES; v++) {
+            _voiceTick(&_voice[v]);
+            playing |= _voice[v].playing;
+        }
+        _playing = playing;
+    }
+    _outputNote();
+#endif
+}
+
+/**
+ * @brief Timer compare interrupt: one sample of the mixed square waves
+ *
+ */
+void ToneTimer::handleInterrupt()
+{
+#if defined(__AVR__)
+    uint8_t level = 0;
+
+    for (uint8_t v = 0; v < TONE_VOICES; v++) {
+        ToneVoice *voice = &_voice[v];
+        voice->phase += voice->inc;
+        if (voice->phase < voice->duty) level++;
+    }
+
+    //-- First order sigma-delta: high for level / _sounding of the samples
+    _mix += level;
+    if (_sounding && (_mix >= _sounding)) {
+        _mix -= _sounding;
+        *_port |= _mask;
+    } else {
+        *_port &= ~_mask;
+    }
+
+    if (--_tick) return;
+    _tick = _TICKS_PER_MS;
+
+    bool changed = false;
+    bool playing = false;
+    for (uint8_t v = 0; v < TONE_VOICES; v++) {
+        changed |= _voiceTick(&_voice[v]);
+        playing |= _voice[v].playing;
+    }
+    if (changed) _countSounding();
+    if (!playing) {
+        _playing = false;
+        _stopTimer();
+    }
+#endif
+}
+
+#endif //__USE_TONE_TIMER
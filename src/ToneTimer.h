@@ -0,0 +1,89 @@
+/**
+ * @file ToneTimer.h
+ * @author David LEVAL (dleval@dle-dev.com)
+ * @brief Timer driven tone generator with note queues and voice mixing
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TONETIMER_h
+#define TONETIMER_h
+
+#include <stdint.h>
+
+/** Configuration *************************************************************/
+//-- Uncomment to play the sounds in the background with ToneTimer. On AVR it
+//-- uses Timer2, like the Arduino tone() function: they cannot be used in the
+//-- same sketch.
+// #define __USE_TONE_TIMER    1
+
+#define TONE_TIMER_RATE         20000   //-- Waveform sample rate (Hz, multiple of 1000)
+#define TONE_QUEUE_SIZE         8       //-- Size of the note queue of a voice (power of 2, one place kept free)
+#define TONE_VOICES             2       //-- Voices played together
+
+/******************************************************************************/
+
+/**
+ * @brief One note of the queue
+ */
+typedef struct {
+    uint16_t inc;       //-- Phase increment per sample (1/65536 turn), 0 = silence
+    uint16_t duty;      //-- High part of the period (1/65536 period): volume
+    uint16_t time;      //-- Duration (ms)
+    int16_t sweep;      //-- Exponential sweep: change of the increment per ms (1/2^20)
+    uint16_t on;        //-- Gate: sound during on ms, then silence during off ms
+    uint16_t off;       //-- (off = 0: no gate)
+} ToneEvent;
+
+/**
+ * @brief Square wave generator fed by note queues, one per voice
+ *
+ * The timer interrupt runs a phase accumulator (DDS) per voice at
+ * TONE_TIMER_RATE. Each voice is high when its phase is below the duty of
+ * its note, and the voices are mixed by a sigma-delta modulator: the buzzer
+ * pin density follows the number of high voices divided by the number of
+ * voices playing a note, so a single voice gives the plain square wave.
+ * A note can sweep: its phase increment is multiplied by a constant every
+ * ms, so the frequency glides exponentially without any step, and it can be
+ * gated to sound by pulses during the sweep.
+ * When a note ends, the interrupt takes the next one from the queue of the
+ * voice, so play() returns at once. The timer only runs while there are
+ * notes to play.
+ * Without the hardware timer (not AVR), update() must be called from the
+ * main loop: it follows the queues with millis() and uses tone() / noTone()
+ * for the first voice playing a note.
+ */
+class ToneTimer
+{
+public:
+    static void begin(uint8_t pin);
+    static void play(uint16_t frequency, uint16_t time, uint8_t volume, uint8_t voice = 0);
+    static void playKey(uint8_t key, uint16_t time, uint8_t volume, uint8_t voice = 0);
+    static void repeatKey(uint8_t key, uint16_t on, uint16_t off, uint16_t count, uint8_t volume, uint8_t voice = 0);
+    static void sweep(uint16_t from, uint16_t to, uint16_t time, uint8_t volume, uint16_t on = 0, uint16_t off = 0, uint8_t voice = 0);
+    static void stop();
+    static bool busy() {return _playing;};
+    static uint8_t queueFree(uint8_t voice = 0);
+    static void update();
+    static void handleInterrupt();
+
+private:
+    static volatile bool _playing;
+    static void _push(ToneEvent *note, uint8_t volume, uint8_t voice);
+};
+
+#endif //TONETIMER_h
@@ -8,31 +8,165 @@ US::US(int pinTrigger, int pinEcho){
   US::init(pinTrigger,pinEcho);
 }
 
+#ifdef __USE_US_ASYNC
+//-- Echo timing, shared with the interrupt (one sensor)
+#define _ECHO_IDLE      0   //-- No ping in progress
+#define _ECHO_WAIT      1   //-- Ping sent, waiting for the echo
+#define _ECHO_HIGH      2   //-- Echo started
+#define _ECHO_DONE      3   //-- Echo received, _echoWidth is valid
+
+static volatile uint8_t _echoState = _ECHO_IDLE;
+static volatile uint32_t _echoStart;    //-- Ping or echo start (us)
+static volatile uint32_t _echoWidth;    //-- Echo width (us)
+#if defined(__AVR__)
+static volatile uint8_t *_echoPort;
+static uint8_t _echoMask;
+#else
+static uint8_t _echoPin;
+#endif
+#endif
+
 void US::init(int pinTrigger, int pinEcho)
 {
   _pinTrigger = pinTrigger;
   _pinEcho = pinEcho;
   pinMode( _pinTrigger , OUTPUT );
   pinMode( _pinEcho , INPUT );
+  _echo = 0;
+  _count = 0;
+#ifdef __USE_US_ASYNC
+  _distance = US_NO_ECHO;
+  _time = 0;
+  _pingTime = millis() - US_PING_PERIOD;
+  _echoState = _ECHO_IDLE;
+#if defined(__AVR__)
+  //-- Pin change interrupt on the echo pin
+  _echoPort = portInputRegister(digitalPinToPort(pinEcho));
+  _echoMask = digitalPinToBitMask(pinEcho);
+  *digitalPinToPCMSK(pinEcho) |= _BV(digitalPinToPCMSKbit(pinEcho));
+  PCIFR |= _BV(digitalPinToPCICRbit(pinEcho));
+  PCICR |= _BV(digitalPinToPCICRbit(pinEcho));
+#else
+  _echoPin = pinEcho;
+  attachInterrupt(digitalPinToInterrupt(pinEcho), US::handleEcho, CHANGE);
+#endif
+#endif
 }
 
-long US::TP_init()
+long US::TP_init(uint32_t timeout)
 {
     digitalWrite(_pinTrigger, LOW);
     delayMicroseconds(2);
     digitalWrite(_pinTrigger, HIGH);
     delayMicroseconds(10);
     digitalWrite(_pinTrigger, LOW);
-    long microseconds = pulseIn(_pinEcho,HIGH,40000); //40000
+    long microseconds = pulseIn(_pinEcho,HIGH,timeout);
     return microseconds;
 }
 
-float US::read(){
-  long microseconds = US::TP_init();
+#ifndef __USE_US_ASYNC
+//-- Send a ping and wait for the echo, at most timeout us: a short
+//-- timeout only sees the obstacles that are close
+float US::read(uint32_t timeout){
+  long microseconds = US::TP_init(timeout);
+  _echo = microseconds;
+  _count++;
   long distance;
   distance = microseconds/29/2;
   if (distance == 0){
-    distance = 999;
+    distance = US_NO_ECHO;
   }
   return distance;
-}
\ No newline at end of file
+}
+#else
+//-- Last measured distance, a new ping is sent if needed
+float US::read(){
+  update();
+  return _distance;
+}
+
+//-- Run the ranging: collect the echo of the last ping and send a new ping
+//-- every US_PING_PERIOD. Returns true when a new distance is available.
+//-- Takes a few us: must be called periodically (read() calls it)
+bool US::update()
+{
+  bool measure = false;
+  uint8_t state = _echoState;
+
+  if (state == _ECHO_DONE) {
+    _echo = (_echoWidth > US_ECHO_TIMEOUT) ? 0 : _echoWidth;
+    _count++;
+    long distance = _echoWidth/29/2;
+    _distance = (distance == 0) ? US_NO_ECHO : distance;
+    _time = millis();
+    _echoState = _ECHO_IDLE;
+    measure = true;
+  }
+  else if (state != _ECHO_IDLE) {
+    //-- Nothing in range
+    noInterrupts();
+    uint32_t elapsed = micros() - _echoStart;
+    interrupts();
+    if (elapsed > US_ECHO_TIMEOUT) {
+      _echoState = _ECHO_IDLE;
+      _echo = 0;
+      _count++;
+      _distance = US_NO_ECHO;
+      _time = millis();
+      measure = true;
+    }
+  }
+
+  if ((_echoState == _ECHO_IDLE) && ((millis() - _pingTime) >= US_PING_PERIOD)) ping();
+
+  return measure;
+}
+
+//-- Send a ping, the echo is timed by handleEcho()
+void US::ping()
+{
+  _pingTime = millis();
+  digitalWrite(_pinTrigger, LOW);
+  delayMicroseconds(2);
+  digitalWrite(_pinTrigger, HIGH);
+  delayMicroseconds(10);
+  digitalWrite(_pinTrigger, LOW);
+  noInterrupts();
+  _echoStart = micros();
+  _echoState = _ECHO_WAIT;
+  interrupts();
+}
+
+//-- Echo pin change: time the echo pulse
+void US::handleEcho()
+{
+#if defined(__AVR__)
+  bool level = (*_echoPort & _echoMask) != 0;
+#else
+  bool level = digitalRead(_echoPin) == HIGH;
+#endif
+
+  if (level && (_echoState == _ECHO_WAIT)) {
+    _echoStart = micros();
+    _echoState = _ECHO_HIGH;
+  }
+  else if (!level && (_echoState == _ECHO_HIGH)) {
+    _echoWidth = micros() - _echoStart;
+    _echoState = _ECHO_DONE;
+  }
+}
+
+#if defined(__AVR__)
+ISR(PCINT0_vect)
+{
+  US::handleEcho();
+}
+
+#if defined(PCINT1_vect)
+ISR(PCINT1_vect, ISR_ALIASOF(PCINT0_vect));
+#endif
+#if defined(PCINT2_vect)
+ISR(PCINT2_vect, ISR_ALIASOF(PCINT0_vect));
+#endif
+#endif
+#endif //__USE_US_ASYNC
\ No newline at end of file
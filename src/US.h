@@ -2,19 +2,52 @@
 #define US_h
 #include <Arduino.h>
 
+/** Configuration *************************************************************/
+//-- Uncomment to measure the distance in the background: the echo is timed
+//-- by an interrupt and read() returns the last measure without waiting.
+//-- On AVR the pin change interrupts are used (all the PCINT vectors, not
+//-- compatible with SoftwareSerial), attachInterrupt() elsewhere.
+// #define __USE_US_ASYNC      1
+
+#define US_ECHO_TIMEOUT     40000   //-- No echo after this time (us)
+#define US_ECHO_START       600     //-- Worst case delay from the trigger to the echo (us)
+#define US_PING_PERIOD      60      //-- Minimum time between two pings (ms)
+#define US_NO_ECHO          999     //-- Distance returned without echo (cm)
+
+/******************************************************************************/
+
 class US
 {
 public:
 	US();
 	void init(int pinTrigger, int pinEcho);
 	US(int pinTrigger, int pinEcho);
+#ifdef __USE_US_ASYNC
 	float read();
+#else
+	float read(uint32_t timeout = US_ECHO_TIMEOUT);
+#endif
+	uint16_t getEcho() {return _echo;};
+	uint8_t getCount() {return _count;};
+#ifdef __USE_US_ASYNC
+	bool update();
+	uint32_t getTime() {return _time;};
+	static void handleEcho();
+#endif
 
 private:
 	int _pinTrigger;
 	int _pinEcho;
-	long TP_init();
+	uint16_t _echo;         //-- Echo width of the last measure (us), 0 = no echo
+	uint8_t _count;         //-- Number of measures (wraps around)
+	long TP_init(uint32_t timeout);
+#ifdef __USE_US_ASYNC
+	float _distance;        //-- Last measure (cm)
+	uint32_t _time;         //-- Time of the last measure (ms)
+	uint32_t _pingTime;     //-- Time of the last ping (ms)
+	void ping();
+#endif
 
 };
 
-#endif //US_h
\ No newline at end of file
+#endif //US_h